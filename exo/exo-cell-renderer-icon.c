@@ -23,6 +23,7 @@
 #endif
 
 #include <gio/gio.h>
+#include <glib/gstdio.h>
 
 #include <exo/exo-cell-renderer-icon.h>
 #include <exo/exo-gdk-pixbuf-extensions.h>
@@ -48,11 +49,27 @@
  * rendering icons based on the state of the view if the
  * <link linkend="ExoCellRendererIcon--follow-state">follow-state</link>
  * property is set.
+ *
+ * If the <link linkend="ExoCellRendererIcon--async">async</link> property
+ * is set, icons are loaded in a worker thread and a placeholder is drawn
+ * until the icon is available, so rendering never blocks on loading images.
  **/
 
 /* HACK: fix dead API via #define */
 # define gtk_icon_info_free(info) g_object_unref (info)
 
+/* Maximum number of loaded icons to keep in the cache */
+#define EXO_CELL_RENDERER_ICON_CACHE_SIZE (512)
+
+/* Minimum time between checks whether an image file changed (in us) */
+#define EXO_CELL_RENDERER_ICON_REVALIDATE_INTERVAL (2 * G_USEC_PER_SEC)
+
+/* Variants of a cached icon, combined as bit flags */
+#define EXO_CELL_RENDERER_ICON_VARIANT_SELECTED    (1 << 0)
+#define EXO_CELL_RENDERER_ICON_VARIANT_PRELIT      (1 << 1)
+#define EXO_CELL_RENDERER_ICON_VARIANT_INSENSITIVE (1 << 2)
+#define EXO_CELL_RENDERER_ICON_N_VARIANTS          (1 << 3)
+
 /* Property identifiers */
 enum
 {
@@ -61,10 +78,18 @@ enum
   PROP_ICON,
   PROP_GICON,
   PROP_SIZE,
+  PROP_ASYNC,
 };
 
 
 
+typedef struct _ExoCellRendererIconCache   ExoCellRendererIconCache;
+typedef struct _ExoCellRendererIconEntry   ExoCellRendererIconEntry;
+typedef struct _ExoCellRendererIconLoad    ExoCellRendererIconLoad;
+typedef struct _ExoCellRendererIconVariant ExoCellRendererIconVariant;
+
+
+
 static void exo_cell_renderer_icon_finalize     (GObject                  *object);
 static void exo_cell_renderer_icon_get_property (GObject                  *object,
                                                  guint                     prop_id,
@@ -94,11 +119,62 @@ struct _ExoCellRendererIconPrivate
 {
   guint  follow_state : 1;
   guint  icon_static : 1;
+  guint  async : 1;
   gchar *icon;
   GIcon *gicon;
   gint   size;
 };
 
+/* The process-wide cache of loaded icons, shared by all renderers.
+ * The stamp is increased whenever the cache is cleared, so loads
+ * started before are dropped when they complete.
+ */
+struct _ExoCellRendererIconCache
+{
+  GHashTable *entries;  /* key -> ExoCellRendererIconEntry */
+  GQueue      lru;      /* entries, most recently used first */
+  GSList     *screens;  /* screens whose icon theme and settings are watched */
+  guint       stamp;
+  guint       hits;
+  guint       misses;
+};
+
+struct _ExoCellRendererIconVariant
+{
+  GdkPixbuf *pixbuf;
+  GdkColor   selected_color;     /* colors the variant was */
+  GdkColor   insensitive_color;  /* derived with */
+};
+
+struct _ExoCellRendererIconEntry
+{
+  gchar                     *key;
+  GList                      lru_link;
+  GdkPixbuf                 *pixbuf;   /* %NULL while loading or if the load failed */
+  GdkPixbuf                 *previous; /* the outdated image while a file is reloaded */
+  ExoCellRendererIconVariant variants[EXO_CELL_RENDERER_ICON_N_VARIANTS];
+  GSList                    *widgets;  /* widgets to redraw once the icon is loaded */
+  gchar                     *filename; /* the image file of a file icon, */
+  gint64                     mtime;    /* and its modification time */
+  goffset                    size;     /* and size when it was loaded, */
+  gint64                     checked;  /* and the last time that was verified */
+  guint                      loading : 1;
+};
+
+struct _ExoCellRendererIconLoad
+{
+  gchar           *key;
+  gchar           *icon;
+  GIcon           *gicon;
+  gchar           *filename;
+  ExoThumbnailSize thumbnail_size;
+  guint            stamp;
+};
+
+
+
+static ExoCellRendererIconCache icon_cache;
+
 
 
 G_DEFINE_TYPE_WITH_PRIVATE (ExoCellRendererIcon, exo_cell_renderer_icon, GTK_TYPE_CELL_RENDERER)
@@ -202,6 +278,26 @@ exo_cell_renderer_icon_class_init (ExoCellRendererIconClass *klass)
                                                      _("The size of the icon to render in pixels."),
                                                      1, G_MAXINT, 48,
                                                      EXO_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+  /**
+   * ExoCellRendererIcon:async:
+   *
+   * Whether to load icons asynchronously. If %TRUE, icons are loaded in
+   * a worker thread, and until its icon is loaded the cell shows a
+   * placeholder: the previous image of a file that is being reloaded, or
+   * else the generic "image-loading" icon of the theme. The widget is
+   * redrawn once the icon is loaded. Loaded icons are kept around, so
+   * they can be rendered immediately afterwards.
+   *
+   * Since: 4.16
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_ASYNC,
+                                   g_param_spec_boolean ("async",
+                                                         _("Async"),
+                                                         _("Whether to load icons asynchronously."),
+                                                         FALSE,
+                                                         EXO_PARAM_READWRITE));
 }
 
 
@@ -257,6 +353,10 @@ exo_cell_renderer_icon_get_property (GObject    *object,
       g_value_set_int (value, priv->size);
       break;
 
+    case PROP_ASYNC:
+      g_value_set_boolean (value, priv->async);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -301,6 +401,10 @@ exo_cell_renderer_icon_set_property (GObject      *object,
       priv->size = g_value_get_int (value);
       break;
 
+    case PROP_ASYNC:
+      priv->async = g_value_get_boolean (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -357,123 +461,713 @@ exo_cell_renderer_icon_get_size (GtkCellRenderer *renderer,
 }
 
 
+
 static void
-exo_cell_renderer_icon_render (GtkCellRenderer     *renderer,
-                               cairo_t             *cr,
-                               GtkWidget           *widget,
-                               const GdkRectangle  *background_area,
-                               const GdkRectangle  *cell_area,
-                               GtkCellRendererState flags)
+exo_cell_renderer_icon_warn (const gchar  *icon,
+                             GIcon        *gicon,
+                             const GError *error)
 {
-  GdkRectangle        clip_area;
-  GdkRectangle       *expose_area = &clip_area;
-  GdkRGBA            *color_rgba;
-  GdkColor            color_gdk;
-  GtkStyleContext    *style_context;
-  const ExoCellRendererIconPrivate *priv = exo_cell_renderer_icon_get_instance_private (EXO_CELL_RENDERER_ICON (renderer));
-  GtkIconTheme                     *icon_theme;
-  GdkRectangle                      icon_area;
-  GdkRectangle                      draw_area;
-  const gchar                      *filename;
-  GtkIconInfo                      *icon_info = NULL;
-  GdkPixbuf                        *icon = NULL;
-  GdkPixbuf                        *temp;
-  GError                           *err = NULL;
-  gchar                            *display_name = NULL;
-  gint                             *icon_sizes;
-  gint                              icon_size;
-  gint                              n;
+  gchar *display_name = NULL;
 
-  gdk_cairo_get_clip_rectangle (cr, expose_area);
+  /* better let the user know whats going on, might be surprising otherwise */
+  if (G_LIKELY (icon != NULL))
+    {
+      display_name = g_filename_display_name (icon);
+    }
+  else if (G_UNLIKELY (gicon != NULL
+                       && g_object_class_find_property (G_OBJECT_GET_CLASS (gicon),
+                                                        "name")))
+    {
+      g_object_get (gicon, "name", &display_name, NULL);
+    }
+
+  if (display_name != NULL)
+    {
+      g_warning ("Failed to load \"%s\": %s", display_name, error->message);
+      g_free (display_name);
+    }
+}
 
-  /* verify that we have an icon */
-  if (G_UNLIKELY (priv->icon == NULL && priv->gicon == NULL))
-    return;
+
+
+static gboolean
+exo_cell_renderer_icon_resolve (const ExoCellRendererIconPrivate *priv,
+                                GtkIconTheme                     *icon_theme,
+                                gchar                           **filename_return,
+                                GtkIconInfo                     **icon_info_return)
+{
+  const gchar *filename;
+  GtkIconInfo *icon_info = NULL;
+  gint        *icon_sizes;
+  gint         icon_size;
+  gint         n;
+
+  *filename_return = NULL;
+  *icon_info_return = NULL;
 
   /* icon may be either an image file or a named icon */
   if (priv->icon != NULL && g_path_is_absolute (priv->icon))
     {
       /* load the icon via the thumbnail database */
-      icon = _exo_thumbnail_get_for_file (priv->icon, (priv->size > 128) ? EXO_THUMBNAIL_SIZE_LARGE : EXO_THUMBNAIL_SIZE_NORMAL, &err);
+      *filename_return = g_strdup (priv->icon);
+      return TRUE;
     }
-  else if (priv->icon != NULL || priv->gicon != NULL)
+
+  if (priv->icon != NULL)
     {
       /* determine the best icon size (GtkIconTheme is somewhat messy scaling up small icons) */
-      icon_theme = gtk_icon_theme_get_for_screen (gtk_widget_get_screen (widget));
-
-      if (priv->icon != NULL)
+      icon_sizes = gtk_icon_theme_get_icon_sizes (icon_theme, priv->icon);
+      for (icon_size = -1, n = 0; icon_sizes[n] != 0; ++n)
         {
-          icon_sizes = gtk_icon_theme_get_icon_sizes (icon_theme, priv->icon);
-          for (icon_size = -1, n = 0; icon_sizes[n] != 0; ++n)
-            {
-              /* we can use any size if scalable, because we load the file directly */
-              if (icon_sizes[n] == -1)
-                icon_size = priv->size;
-              else if (icon_sizes[n] > icon_size && icon_sizes[n] <= priv->size)
-                icon_size = icon_sizes[n];
-            }
-          g_free (icon_sizes);
-
-          /* if we don't know any icon sizes at all, the icon is probably not present */
-          if (G_UNLIKELY (icon_size < 0))
+          /* we can use any size if scalable, because we load the file directly */
+          if (icon_sizes[n] == -1)
             icon_size = priv->size;
-
-          /* lookup the icon in the icon theme */
-          icon_info = gtk_icon_theme_lookup_icon (icon_theme, priv->icon, icon_size, 0);
+          else if (icon_sizes[n] > icon_size && icon_sizes[n] <= priv->size)
+            icon_size = icon_sizes[n];
         }
-      else if (priv->gicon != NULL)
+      g_free (icon_sizes);
+
+      /* if we don't know any icon sizes at all, the icon is probably not present */
+      if (G_UNLIKELY (icon_size < 0))
+        icon_size = priv->size;
+
+      /* lookup the icon in the icon theme */
+      icon_info = gtk_icon_theme_lookup_icon (icon_theme, priv->icon, icon_size, 0);
+    }
+  else if (priv->gicon != NULL)
+    {
+      icon_info = gtk_icon_theme_lookup_by_gicon (icon_theme,
+                                                  priv->gicon,
+                                                  priv->size,
+                                                  GTK_ICON_LOOKUP_USE_BUILTIN);
+    }
+
+  if (G_UNLIKELY (icon_info == NULL))
+    return FALSE;
+
+  /* check if we have an SVG icon here */
+  filename = gtk_icon_info_get_filename (icon_info);
+  if (filename != NULL && g_str_has_suffix (filename, ".svg"))
+    {
+      /* loading SVG icons is terribly slow, so we try to use thumbnail instead, and we use the
+       * real available cell area directly here, because loading thumbnails involves scaling anyway
+       * and this way we need to the thumbnail pixbuf scale only once.
+       */
+      *filename_return = g_strdup (filename);
+      gtk_icon_info_free (icon_info);
+    }
+  else
+    {
+      /* regularly load the icon from the theme */
+      *icon_info_return = icon_info;
+    }
+
+  return TRUE;
+}
+
+
+
+static GdkPixbuf*
+exo_cell_renderer_icon_load (const ExoCellRendererIconPrivate *priv,
+                             gchar                            *filename,
+                             GtkIconInfo                      *icon_info)
+{
+  GdkPixbuf *icon;
+  GError    *err = NULL;
+
+  if (filename != NULL)
+    {
+      icon = _exo_thumbnail_get_for_file (filename, (priv->size > 128) ? EXO_THUMBNAIL_SIZE_LARGE : EXO_THUMBNAIL_SIZE_NORMAL, &err);
+      g_free (filename);
+    }
+  else
+    {
+      icon = gtk_icon_info_load_icon (icon_info, &err);
+      gtk_icon_info_free (icon_info);
+    }
+
+  /* check if we failed */
+  if (G_UNLIKELY (icon == NULL))
+    {
+      exo_cell_renderer_icon_warn (priv->icon, priv->gicon, err);
+      g_error_free (err);
+    }
+
+  return icon;
+}
+
+
+
+static void
+exo_cell_renderer_icon_entry_free (gpointer data)
+{
+  ExoCellRendererIconEntry *entry = data;
+  gint                      n;
+
+  g_queue_unlink (&icon_cache.lru, &entry->lru_link);
+
+  if (entry->pixbuf != NULL)
+    g_object_unref (entry->pixbuf);
+  if (entry->previous != NULL)
+    g_object_unref (entry->previous);
+  for (n = 0; n < EXO_CELL_RENDERER_ICON_N_VARIANTS; ++n)
+    if (entry->variants[n].pixbuf != NULL)
+      g_object_unref (entry->variants[n].pixbuf);
+  g_slist_free_full (entry->widgets, g_object_unref);
+  g_free (entry->filename);
+  g_free (entry->key);
+  g_slice_free (ExoCellRendererIconEntry, entry);
+}
+
+
+
+static void
+exo_cell_renderer_icon_load_free (ExoCellRendererIconLoad *load)
+{
+  if (load->gicon != NULL)
+    g_object_unref (load->gicon);
+  g_free (load->filename);
+  g_free (load->icon);
+  g_free (load->key);
+  g_slice_free (ExoCellRendererIconLoad, load);
+}
+
+
+
+static void
+exo_cell_renderer_icon_cache_clear (void)
+{
+  /* drop all icons, pending loads will be ignored */
+  g_hash_table_remove_all (icon_cache.entries);
+  icon_cache.stamp++;
+}
+
+
+
+static void
+exo_cell_renderer_icon_cache_clear_variants (void)
+{
+  ExoCellRendererIconEntry *entry;
+  GList                    *lp;
+  gint                      n;
+
+  /* the variants depend on the colors of the style */
+  for (lp = icon_cache.lru.head; lp != NULL; lp = lp->next)
+    {
+      entry = lp->data;
+      for (n = 0; n < EXO_CELL_RENDERER_ICON_N_VARIANTS; ++n)
+        if (entry->variants[n].pixbuf != NULL)
+          {
+            g_object_unref (entry->variants[n].pixbuf);
+            entry->variants[n].pixbuf = NULL;
+          }
+    }
+}
+
+
+
+static void
+exo_cell_renderer_icon_cache_watch (GdkScreen *screen)
+{
+  /* check if we already watch the screen */
+  if (G_LIKELY (g_slist_find (icon_cache.screens, screen) != NULL))
+    return;
+
+  icon_cache.screens = g_slist_prepend (icon_cache.screens, screen);
+
+  /* screens live as long as the display, so we never disconnect */
+  g_signal_connect (gtk_icon_theme_get_for_screen (screen), "changed",
+                    G_CALLBACK (exo_cell_renderer_icon_cache_clear), NULL);
+  g_signal_connect (gtk_settings_get_for_screen (screen), "notify::gtk-icon-theme-name",
+                    G_CALLBACK (exo_cell_renderer_icon_cache_clear), NULL);
+  g_signal_connect (gtk_settings_get_for_screen (screen), "notify::gtk-theme-name",
+                    G_CALLBACK (exo_cell_renderer_icon_cache_clear_variants), NULL);
+  g_signal_connect (gtk_settings_get_for_screen (screen), "notify::gtk-application-prefer-dark-theme",
+                    G_CALLBACK (exo_cell_renderer_icon_cache_clear_variants), NULL);
+}
+
+
+
+static gchar*
+exo_cell_renderer_icon_get_filename (const ExoCellRendererIconPrivate *priv)
+{
+  GFile *file;
+
+  /* icons given as image files may change on disk */
+  if (priv->icon != NULL)
+    return g_path_is_absolute (priv->icon) ? g_strdup (priv->icon) : NULL;
+
+  if (G_IS_FILE_ICON (priv->gicon))
+    {
+      file = g_file_icon_get_file (G_FILE_ICON (priv->gicon));
+      return g_file_get_path (file);
+    }
+
+  return NULL;
+}
+
+
+
+static gboolean
+exo_cell_renderer_icon_entry_is_current (ExoCellRendererIconEntry *entry)
+{
+  GStatBuf statb;
+  gint64   now;
+
+  /* icons from the theme are dropped when the theme changes */
+  if (G_LIKELY (entry->filename == NULL || entry->loading))
+    return TRUE;
+
+  /* don't stat the file for every paint */
+  now = g_get_monotonic_time ();
+  if (now - entry->checked < EXO_CELL_RENDERER_ICON_REVALIDATE_INTERVAL)
+    return TRUE;
+  entry->checked = now;
+
+  /* check whether the file was modified since the icon was loaded */
+  if (g_stat (entry->filename, &statb) < 0)
+    return (entry->mtime == -1);
+
+  return (entry->mtime == (gint64) statb.st_mtime && entry->size == (goffset) statb.st_size);
+}
+
+
+
+static void
+exo_cell_renderer_icon_cache_trim (void)
+{
+  ExoCellRendererIconEntry *entry;
+  GList                    *lp;
+  GList                    *prev;
+
+  /* drop the least recently used icons, but keep the pending loads */
+  for (lp = icon_cache.lru.tail; lp != NULL && icon_cache.lru.length > EXO_CELL_RENDERER_ICON_CACHE_SIZE; lp = prev)
+    {
+      prev = lp->prev;
+      entry = lp->data;
+      if (!entry->loading)
+        g_hash_table_remove (icon_cache.entries, entry->key);
+    }
+}
+
+
+
+static void
+exo_cell_renderer_icon_loaded (ExoCellRendererIconLoad *load,
+                               GdkPixbuf               *pixbuf,
+                               GError                  *error)
+{
+  ExoCellRendererIconEntry *entry;
+  GSList                   *lp;
+
+  if (G_UNLIKELY (pixbuf == NULL))
+    {
+      exo_cell_renderer_icon_warn (load->icon, load->gicon, error);
+      g_error_free (error);
+    }
+
+  /* check if the cache was cleared in the meantime */
+  entry = (load->stamp == icon_cache.stamp) ? g_hash_table_lookup (icon_cache.entries, load->key) : NULL;
+  if (G_LIKELY (entry != NULL))
+    {
+      entry->pixbuf = pixbuf;
+      entry->loading = FALSE;
+
+      /* the outdated image is no longer needed */
+      if (entry->previous != NULL)
         {
-          icon_info = gtk_icon_theme_lookup_by_gicon (icon_theme,
-                                                      priv->gicon,
-                                                      priv->size,
-                                                      GTK_ICON_LOOKUP_USE_BUILTIN);
+          g_object_unref (entry->previous);
+          entry->previous = NULL;
         }
 
-      if (G_UNLIKELY (icon_info == NULL))
-        return;
+      /* redraw the widgets waiting for the icon */
+      for (lp = entry->widgets; lp != NULL; lp = lp->next)
+        gtk_widget_queue_draw (lp->data);
+      g_slist_free_full (entry->widgets, g_object_unref);
+      entry->widgets = NULL;
+    }
+  else if (pixbuf != NULL)
+    {
+      g_object_unref (pixbuf);
+    }
+
+  exo_cell_renderer_icon_load_free (load);
+}
+
+
+
+static void
+exo_cell_renderer_icon_load_thread (GTask        *task,
+                                    gpointer      source_object,
+                                    gpointer      task_data,
+                                    GCancellable *cancellable)
+{
+  ExoCellRendererIconLoad *load = task_data;
+  GdkPixbuf               *pixbuf;
+  GError                  *err = NULL;
+
+  pixbuf = _exo_thumbnail_get_for_file (load->filename, load->thumbnail_size, &err);
+  if (G_LIKELY (pixbuf != NULL))
+    g_task_return_pointer (task, pixbuf, g_object_unref);
+  else
+    g_task_return_error (task, err);
+}
+
+
+
+static void
+exo_cell_renderer_icon_load_thread_ready (GObject      *object,
+                                          GAsyncResult *result,
+                                          gpointer      user_data)
+{
+  GdkPixbuf *pixbuf;
+  GError    *err = NULL;
+
+  pixbuf = g_task_propagate_pointer (G_TASK (result), &err);
+  exo_cell_renderer_icon_loaded (user_data, pixbuf, err);
+}
+
 
-      /* check if we have an SVG icon here */
-      filename = gtk_icon_info_get_filename (icon_info);
-      if (filename != NULL && g_str_has_suffix (filename, ".svg"))
+
+static void
+exo_cell_renderer_icon_load_icon_ready (GObject      *object,
+                                        GAsyncResult *result,
+                                        gpointer      user_data)
+{
+  GdkPixbuf *pixbuf;
+  GError    *err = NULL;
+
+  pixbuf = gtk_icon_info_load_icon_finish (GTK_ICON_INFO (object), result, &err);
+  exo_cell_renderer_icon_loaded (user_data, pixbuf, err);
+}
+
+
+
+static void
+exo_cell_renderer_icon_load_async (const ExoCellRendererIconPrivate *priv,
+                                   ExoCellRendererIconEntry         *entry,
+                                   gchar                            *filename,
+                                   GtkIconInfo                      *icon_info)
+{
+  ExoCellRendererIconLoad *load;
+  GTask                   *task;
+
+  load = g_slice_new0 (ExoCellRendererIconLoad);
+  load->key = g_strdup (entry->key);
+  load->icon = g_strdup (priv->icon);
+  load->gicon = (priv->gicon != NULL) ? g_object_ref (priv->gicon) : NULL;
+  load->stamp = icon_cache.stamp;
+
+  if (filename != NULL)
+    {
+      /* load the icon via the thumbnail database in a worker thread */
+      load->filename = filename;
+      load->thumbnail_size = (priv->size > 128) ? EXO_THUMBNAIL_SIZE_LARGE : EXO_THUMBNAIL_SIZE_NORMAL;
+
+      task = g_task_new (NULL, NULL, exo_cell_renderer_icon_load_thread_ready, load);
+      g_task_set_task_data (task, load, NULL);
+      g_task_run_in_thread (task, exo_cell_renderer_icon_load_thread);
+      g_object_unref (task);
+    }
+  else
+    {
+      /* let the icon theme load the icon in a worker thread */
+      gtk_icon_info_load_icon_async (icon_info, NULL, exo_cell_renderer_icon_load_icon_ready, load);
+      gtk_icon_info_free (icon_info);
+    }
+}
+
+
+
+static ExoCellRendererIconEntry*
+exo_cell_renderer_icon_lookup (const ExoCellRendererIconPrivate *priv,
+                               GtkWidget                        *widget)
+{
+  ExoCellRendererIconEntry *entry;
+  GtkIconTheme             *icon_theme;
+  GtkIconInfo              *icon_info;
+  GdkPixbuf                *previous = NULL;
+  GStatBuf                  statb;
+  gchar                    *filename;
+  gchar                    *name;
+  gchar                    *key;
+
+  /* determine the cache key for the icon */
+  name = (priv->icon != NULL) ? g_strdup (priv->icon) : g_icon_to_string (priv->gicon);
+  if (G_UNLIKELY (name == NULL))
+    return NULL;
+
+  /* icons differ between icon themes */
+  icon_theme = gtk_icon_theme_get_for_screen (gtk_widget_get_screen (widget));
+  key = g_strdup_printf ("%p:%d:%s", icon_theme, priv->size, name);
+  g_free (name);
+
+  if (G_UNLIKELY (icon_cache.entries == NULL))
+    icon_cache.entries = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, exo_cell_renderer_icon_entry_free);
+
+  /* check if the icon was loaded or is being loaded already, and
+   * reload image files that were modified since
+   */
+  entry = g_hash_table_lookup (icon_cache.entries, key);
+  if (G_UNLIKELY (entry != NULL && !exo_cell_renderer_icon_entry_is_current (entry)))
+    {
+      /* keep showing the outdated image until the file is reloaded */
+      if (entry->pixbuf != NULL)
+        previous = g_object_ref (entry->pixbuf);
+      g_hash_table_remove (icon_cache.entries, key);
+      entry = NULL;
+    }
+
+  if (G_LIKELY (entry != NULL))
+    {
+      g_free (key);
+      icon_cache.hits++;
+
+      /* move the entry to the front of the LRU queue */
+      g_queue_unlink (&icon_cache.lru, &entry->lru_link);
+      g_queue_push_head_link (&icon_cache.lru, &entry->lru_link);
+
+      /* redraw the widget once the icon is available */
+      if (entry->loading && g_slist_find (entry->widgets, widget) == NULL)
+        entry->widgets = g_slist_prepend (entry->widgets, g_object_ref (widget));
+
+      return entry;
+    }
+
+  icon_cache.misses++;
+  exo_cell_renderer_icon_cache_watch (gtk_widget_get_screen (widget));
+
+  /* remember the icon, so failed lookups are not repeated */
+  entry = g_slice_new0 (ExoCellRendererIconEntry);
+  entry->key = key;
+  entry->lru_link.data = entry;
+  g_hash_table_insert (icon_cache.entries, key, entry);
+  g_queue_push_head_link (&icon_cache.lru, &entry->lru_link);
+  exo_cell_renderer_icon_cache_trim ();
+
+  /* remember the state of an image file, before it is read */
+  entry->filename = exo_cell_renderer_icon_get_filename (priv);
+  if (G_UNLIKELY (entry->filename != NULL))
+    {
+      entry->checked = g_get_monotonic_time ();
+      if (g_stat (entry->filename, &statb) == 0)
         {
-          /* loading SVG icons is terribly slow, so we try to use thumbnail instead, and we use the
-           * real available cell area directly here, because loading thumbnails involves scaling anyway
-           * and this way we need to the thumbnail pixbuf scale only once.
-           */
-          icon = _exo_thumbnail_get_for_file (filename, (priv->size > 128) ? EXO_THUMBNAIL_SIZE_LARGE : EXO_THUMBNAIL_SIZE_NORMAL, &err);
+          entry->mtime = statb.st_mtime;
+          entry->size = statb.st_size;
         }
       else
         {
-          /* regularly load the icon from the theme */
-          icon = gtk_icon_info_load_icon (icon_info, &err);
+          entry->mtime = -1;
         }
-      gtk_icon_info_free (icon_info);
     }
 
-  /* check if we failed */
-  if (G_UNLIKELY (icon == NULL))
+  if (exo_cell_renderer_icon_resolve (priv, icon_theme, &filename, &icon_info))
     {
-      /* better let the user know whats going on, might be surprising otherwise */
-      if (G_LIKELY (priv->icon != NULL))
+      if (priv->async)
         {
-          display_name = g_filename_display_name (priv->icon);
+          entry->loading = TRUE;
+          entry->previous = previous;
+          entry->widgets = g_slist_prepend (NULL, g_object_ref (widget));
+          exo_cell_renderer_icon_load_async (priv, entry, filename, icon_info);
+          return entry;
         }
-      else if (G_UNLIKELY (priv->gicon != NULL
-                           && g_object_class_find_property (G_OBJECT_GET_CLASS (priv->gicon),
-                                                            "name")))
+
+      entry->pixbuf = exo_cell_renderer_icon_load (priv, filename, icon_info);
+    }
+
+  if (previous != NULL)
+    g_object_unref (previous);
+
+  return entry;
+}
+
+
+
+static void
+exo_cell_renderer_icon_get_color (GtkWidget     *widget,
+                                  GtkStateFlags  state,
+                                  const gchar   *property,
+                                  GdkColor      *color)
+{
+  GtkStyleContext *style_context;
+  GdkRGBA         *color_rgba;
+
+  style_context = gtk_widget_get_style_context (widget);
+  gtk_style_context_get (style_context, state, property, &color_rgba, NULL);
+
+  color->pixel = 0;
+  color->red = color_rgba->red * 65535;
+  color->blue = color_rgba->blue * 65535;
+  color->green = color_rgba->green * 65535;
+  gdk_rgba_free (color_rgba);
+}
+
+
+
+static GdkPixbuf*
+exo_cell_renderer_icon_derive (GdkPixbuf      *icon,
+                               GdkPixbuf      *dest,
+                               guint           variant,
+                               const GdkColor *selected_color,
+                               const GdkColor *insensitive_color)
+{
+  ExoGdkPixbufEffect effects = 0;
+
+  /* allocate a new pixbuf unless the caller passed one to reuse */
+  if (G_LIKELY (dest == NULL))
+    {
+      dest = gdk_pixbuf_new (gdk_pixbuf_get_colorspace (icon), gdk_pixbuf_get_has_alpha (icon),
+                             gdk_pixbuf_get_bits_per_sample (icon), gdk_pixbuf_get_width (icon),
+                             gdk_pixbuf_get_height (icon));
+    }
+  else
+    {
+      g_object_ref (G_OBJECT (dest));
+    }
+
+  if ((variant & EXO_CELL_RENDERER_ICON_VARIANT_SELECTED) != 0)
+    effects |= EXO_GDK_PIXBUF_EFFECT_COLORIZE;
+  if ((variant & EXO_CELL_RENDERER_ICON_VARIANT_PRELIT) != 0)
+    effects |= EXO_GDK_PIXBUF_EFFECT_SPOTLIGHT;
+
+  /* colorize and lighten the icon in a single pass */
+  exo_gdk_pixbuf_apply_effects (icon, dest, effects, selected_color, 100);
+
+  /* the insensitive color goes on top of that, in-place */
+  if ((variant & EXO_CELL_RENDERER_ICON_VARIANT_INSENSITIVE) != 0)
+    exo_gdk_pixbuf_apply_effects (dest, dest, EXO_GDK_PIXBUF_EFFECT_COLORIZE, insensitive_color, 100);
+
+  return dest;
+}
+
+
+
+static GdkPixbuf*
+exo_cell_renderer_icon_get_variant (ExoCellRendererIconEntry *entry,
+                                    guint                     variant,
+                                    const GdkColor           *selected_color,
+                                    const GdkColor           *insensitive_color)
+{
+  ExoCellRendererIconVariant *cached = entry->variants + variant;
+  GdkPixbuf                  *dest = NULL;
+  GdkPixbuf                  *temp;
+
+  /* check if the variant was derived with the same colors */
+  if (G_LIKELY (cached->pixbuf != NULL
+             && ((variant & EXO_CELL_RENDERER_ICON_VARIANT_SELECTED) == 0
+                 || gdk_color_equal (&cached->selected_color, selected_color))
+             && ((variant & EXO_CELL_RENDERER_ICON_VARIANT_INSENSITIVE) == 0
+                 || gdk_color_equal (&cached->insensitive_color, insensitive_color))))
+    {
+      icon_cache.hits++;
+      return g_object_ref (cached->pixbuf);
+    }
+
+  icon_cache.misses++;
+
+  /* overwrite the outdated variant if nobody else uses it */
+  if (cached->pixbuf != NULL
+      && G_OBJECT (cached->pixbuf)->ref_count == 1
+      && gdk_pixbuf_get_width (cached->pixbuf) == gdk_pixbuf_get_width (entry->pixbuf)
+      && gdk_pixbuf_get_height (cached->pixbuf) == gdk_pixbuf_get_height (entry->pixbuf)
+      && gdk_pixbuf_get_has_alpha (cached->pixbuf) == gdk_pixbuf_get_has_alpha (entry->pixbuf))
+    dest = cached->pixbuf;
+
+  temp = exo_cell_renderer_icon_derive (entry->pixbuf, dest, variant, selected_color, insensitive_color);
+  if (cached->pixbuf != NULL)
+    g_object_unref (cached->pixbuf);
+  cached->pixbuf = temp;
+  cached->selected_color = *selected_color;
+  cached->insensitive_color = *insensitive_color;
+
+  return g_object_ref (cached->pixbuf);
+}
+
+
+
+static GdkPixbuf*
+exo_cell_renderer_icon_load_placeholder (const ExoCellRendererIconPrivate *priv,
+                                         GtkWidget                        *widget)
+{
+  static const gchar *names[] = { "image-loading", "image-x-generic", NULL };
+  GtkIconTheme       *icon_theme;
+  GtkIconInfo        *icon_info;
+  GdkPixbuf          *pixbuf;
+
+  /* the icon theme keeps the loaded icons around, so this is cheap enough per cell */
+  icon_theme = gtk_icon_theme_get_for_screen (gtk_widget_get_screen (widget));
+  icon_info = gtk_icon_theme_choose_icon (icon_theme, names, priv->size, GTK_ICON_LOOKUP_USE_BUILTIN);
+  if (G_UNLIKELY (icon_info == NULL))
+    return NULL;
+
+  pixbuf = gtk_icon_info_load_icon (icon_info, NULL);
+  g_object_unref (G_OBJECT (icon_info));
+
+  return pixbuf;
+}
+
+
+
+static void
+exo_cell_renderer_icon_render (GtkCellRenderer     *renderer,
+                               cairo_t             *cr,
+                               GtkWidget           *widget,
+                               const GdkRectangle  *background_area,
+                               const GdkRectangle  *cell_area,
+                               GtkCellRendererState flags)
+{
+  const ExoCellRendererIconPrivate *priv = exo_cell_renderer_icon_get_instance_private (EXO_CELL_RENDERER_ICON (renderer));
+  ExoCellRendererIconEntry         *entry;
+  GdkRectangle                      clip_area;
+  GdkRectangle                     *expose_area = &clip_area;
+  GdkRectangle                      icon_area;
+  GdkRectangle                      draw_area;
+  GtkIconTheme                     *icon_theme;
+  GtkIconInfo                      *icon_info;
+  GdkColor                          selected_color = { 0, };
+  GdkColor                          insensitive_color = { 0, };
+  GdkPixbuf                        *icon = NULL;
+  GdkPixbuf                        *temp;
+  gboolean                          scaled = FALSE;
+  gboolean                          placeholder = FALSE;
+  gchar                            *filename;
+  guint                             variant = 0;
+
+  gdk_cairo_get_clip_rectangle (cr, expose_area);
+
+  /* verify that we have an icon */
+  if (G_UNLIKELY (priv->icon == NULL && priv->gicon == NULL))
+    return;
+
+  /* look up the icon in the cache, loading it if necessary */
+  entry = exo_cell_renderer_icon_lookup (priv, widget);
+  if (G_LIKELY (entry != NULL))
+    {
+      if (G_LIKELY (entry->pixbuf != NULL))
         {
-          g_object_get (priv->gicon, "name", &display_name, NULL);
+          icon = g_object_ref (entry->pixbuf);
         }
-
-      if (display_name != NULL)
+      else if (entry->loading)
         {
-          g_warning ("Failed to load \"%s\": %s", display_name, err->message);
-          g_free (display_name);
+          /* draw the previous image or a generic icon until the load completes */
+          if (entry->previous != NULL)
+            icon = g_object_ref (entry->previous);
+          else
+            icon = exo_cell_renderer_icon_load_placeholder (priv, widget);
+          placeholder = TRUE;
         }
-
-      g_error_free (err);
-      return;
     }
+  else
+    {
+      /* the icon cannot be cached, so load it directly */
+      icon_theme = gtk_icon_theme_get_for_screen (gtk_widget_get_screen (widget));
+      if (exo_cell_renderer_icon_resolve (priv, icon_theme, &filename, &icon_info))
+        icon = exo_cell_renderer_icon_load (priv, filename, icon_info);
+    }
+
+  /* check if we have something to draw */
+  if (G_UNLIKELY (icon == NULL))
+    return;
 
   /* determine the real icon size */
   icon_area.width = gdk_pixbuf_get_width (icon);
@@ -486,6 +1180,7 @@ exo_cell_renderer_icon_render (GtkCellRenderer     *renderer,
       temp = exo_gdk_pixbuf_scale_down (icon, TRUE, cell_area->width, cell_area->height);
       g_object_unref (G_OBJECT (icon));
       icon = temp;
+      scaled = TRUE;
 
       /* determine the icon dimensions again */
       icon_area.width = gdk_pixbuf_get_width (icon);
@@ -503,44 +1198,34 @@ exo_cell_renderer_icon_render (GtkCellRenderer     *renderer,
         {
           if ((flags & GTK_CELL_RENDERER_SELECTED) != 0)
             {
-              style_context = gtk_widget_get_style_context (widget);
-              gtk_style_context_get (style_context, gtk_widget_has_focus (widget) ? GTK_STATE_FLAG_SELECTED : GTK_STATE_FLAG_ACTIVE,
-                                     GTK_STYLE_PROPERTY_BACKGROUND_COLOR, &color_rgba,
-                                     NULL);
-
-              color_gdk.pixel = 0;
-              color_gdk.red = color_rgba->red * 65535;
-              color_gdk.blue = color_rgba->blue * 65535;
-              color_gdk.green = color_rgba->green * 65535;
-              gdk_rgba_free (color_rgba);
-              temp = exo_gdk_pixbuf_colorize (icon, &color_gdk);
-              g_object_unref (G_OBJECT (icon));
-              icon = temp;
+              exo_cell_renderer_icon_get_color (widget, gtk_widget_has_focus (widget) ? GTK_STATE_FLAG_SELECTED : GTK_STATE_FLAG_ACTIVE,
+                                                GTK_STYLE_PROPERTY_BACKGROUND_COLOR, &selected_color);
+              variant |= EXO_CELL_RENDERER_ICON_VARIANT_SELECTED;
             }
 
           if ((flags & GTK_CELL_RENDERER_PRELIT) != 0)
-            {
-              temp = exo_gdk_pixbuf_spotlight (icon);
-              g_object_unref (G_OBJECT (icon));
-              icon = temp;
-            }
+            variant |= EXO_CELL_RENDERER_ICON_VARIANT_PRELIT;
         }
 
       /* check if we should render an insensitive icon */
       if (G_UNLIKELY (gtk_widget_get_state_flags(widget) & GTK_STATE_INSENSITIVE || !gtk_cell_renderer_get_sensitive (renderer)))
         {
-          style_context = gtk_widget_get_style_context (widget);
-          gtk_style_context_get (style_context, GTK_STATE_FLAG_INSENSITIVE,
-                                 GTK_STYLE_PROPERTY_COLOR, &color_rgba,
-                                 NULL);
-
-          color_gdk.pixel = 0;
-          color_gdk.red = color_rgba->red * 65535;
-          color_gdk.blue = color_rgba->blue * 65535;
-          color_gdk.green = color_rgba->green * 65535;
-          gdk_rgba_free (color_rgba);
-          temp = exo_gdk_pixbuf_colorize (icon, &color_gdk);
+          exo_cell_renderer_icon_get_color (widget, GTK_STATE_FLAG_INSENSITIVE,
+                                            GTK_STYLE_PROPERTY_COLOR, &insensitive_color);
+          variant |= EXO_CELL_RENDERER_ICON_VARIANT_INSENSITIVE;
+        }
 
+      /* use the cached variant of the icon, unless it was scaled for this cell
+       * or is only drawn while the icon is loading */
+      if (G_UNLIKELY (variant != 0))
+        {
+          if (G_LIKELY (entry != NULL && !scaled && !placeholder))
+            temp = exo_cell_renderer_icon_get_variant (entry, variant, &selected_color, &insensitive_color);
+          else
+            /* only the scaled copy is ours to modify, the pixels of a loaded
+             * icon may be shared with the icon theme's cache */
+            temp = exo_cell_renderer_icon_derive (icon, scaled ? icon : NULL,
+                                                  variant, &selected_color, &insensitive_color);
           g_object_unref (G_OBJECT (icon));
           icon = temp;
         }
@@ -579,5 +1264,30 @@ exo_cell_renderer_icon_new (void)
 
 
 
+/**
+ * exo_cell_renderer_icon_get_cache_stats:
+ * @hits   : return location for the number of cache hits or %NULL.
+ * @misses : return location for the number of cache misses or %NULL.
+ *
+ * Returns the number of hits and misses of the icon cache shared by all
+ * #ExoCellRendererIcon<!---->s in the process, counting both the lookups
+ * of loaded icons and of their selected, prelit and insensitive variants.
+ * This is useful to check whether the cache is large enough for an
+ * application.
+ *
+ * Since: 4.16
+ **/
+void
+exo_cell_renderer_icon_get_cache_stats (guint *hits,
+                                        guint *misses)
+{
+  if (hits != NULL)
+    *hits = icon_cache.hits;
+  if (misses != NULL)
+    *misses = icon_cache.misses;
+}
+
+
+
 #define __EXO_CELL_RENDERER_ICON_C__
 #include <exo/exo-aliasdef.c>
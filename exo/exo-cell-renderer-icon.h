@@ -67,9 +67,12 @@ struct _ExoCellRendererIcon
   GtkCellRenderer __parent__;
 };
 
-GType            exo_cell_renderer_icon_get_type (void) G_GNUC_CONST;
+GType            exo_cell_renderer_icon_get_type        (void) G_GNUC_CONST;
 
-GtkCellRenderer *exo_cell_renderer_icon_new      (void) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
+GtkCellRenderer *exo_cell_renderer_icon_new             (void) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
+
+void             exo_cell_renderer_icon_get_cache_stats (guint *hits,
+                                                         guint *misses);
 
 G_END_DECLS
 
@@ -42,12 +42,15 @@
 #ifdef HAVE_MATH_H
 #include <math.h>
 #endif
-#ifdef HAVE_MMINTRIN_H
-#include <mmintrin.h>
+#ifdef HAVE_IMMINTRIN_H
+#include <immintrin.h>
 #endif
 #ifdef HAVE_STDLIB_H
 #include <stdlib.h>
 #endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
@@ -73,6 +76,11 @@
 #define _O_BINARY 0
 #endif
 
+/* SSE2 and AVX2 kernels, selected at runtime */
+#if defined(__GNUC__) && defined(HAVE_IMMINTRIN_H) && (defined(__x86_64__) || defined(__i386__))
+#define EXO_GDK_PIXBUF_X86_KERNELS 1
+#endif
+
 /**
  * SECTION: exo-gdk-pixbuf-extensions
  * @title: Extensions to gdk-pixbuf
@@ -85,123 +93,532 @@
 
 
 
-/**
- * exo_gdk_pixbuf_colorize:
- * @source : the source #GdkPixbuf.
- * @color  : the new color.
- *
- * Creates a new #GdkPixbuf based on @source, which is
- * colorized to @color.
- *
- * The caller is responsible to free the returned object
- * using g_object_unref() when no longer needed.
- *
- * Returns: the colorized #GdkPixbuf.
- *
- * Since: 0.3.1.3
- **/
-GdkPixbuf*
-exo_gdk_pixbuf_colorize (const GdkPixbuf *source,
-                         const GdkColor  *color)
+/* The pixel kernels below process a single row of pixels. Colorize and
+ * spotlight operate on every byte independently, so they use tables with
+ * one entry per byte position, which repeat every 96 bytes (a multiple
+ * of both 3 and 4 channels and of the vector sizes).
+ */
+#define EXO_GDK_PIXBUF_TABLE_SIZE (96)
+
+typedef void (*ExoGdkPixbufColorizeFunc)  (guchar        *dst,
+                                           const guchar  *src,
+                                           gint           n_bytes,
+                                           const guint16 *factors);
+typedef void (*ExoGdkPixbufSpotlightFunc) (guchar        *dst,
+                                           const guchar  *src,
+                                           gint           n_bytes,
+                                           const guint16 *masks);
+typedef void (*ExoGdkPixbufLucentFunc)    (guchar        *dst,
+                                           const guchar  *src,
+                                           gint           width,
+                                           gint           n_channels,
+                                           guint          percent);
+
+
+
+static inline guchar
+lighten_channel (guchar cur_value)
 {
-  GdkPixbuf *dst;
-  gboolean   has_alpha;
-  gint       dst_row_stride;
-  gint       src_row_stride;
-  gint       width;
-  gint       height;
-  gint       i;
+  gint new_value = cur_value;
 
-  /* determine source parameters */
-  width = gdk_pixbuf_get_width (source);
-  height = gdk_pixbuf_get_height (source);
-  has_alpha = gdk_pixbuf_get_has_alpha (source);
+  new_value += 24 + (new_value >> 3);
+  if (G_UNLIKELY (new_value > 255))
+    new_value = 255;
 
-  /* allocate the destination pixbuf */
-  dst = gdk_pixbuf_new (gdk_pixbuf_get_colorspace (source), has_alpha, gdk_pixbuf_get_bits_per_sample (source), width, height);
+  return (guchar) new_value;
+}
 
-  /* determine row strides on src/dst */
-  dst_row_stride = gdk_pixbuf_get_rowstride (dst);
-  src_row_stride = gdk_pixbuf_get_rowstride (source);
 
-#if defined(__GNUC__) && defined(__MMX__)
-  /* check if there's a good reason to use MMX */
-  if (G_LIKELY (has_alpha && dst_row_stride == width * 4 && src_row_stride == width * 4 && (width * height) % 2 == 0))
+
+static void
+colorize_row (guchar        *dst,
+              const guchar  *src,
+              gint           n_bytes,
+              const guint16 *factors)
+{
+  gint k;
+
+  /* the alpha factor is 256, which keeps the alpha value */
+  for (k = 0; k < n_bytes; ++k)
+    dst[k] = (src[k] * factors[k % EXO_GDK_PIXBUF_TABLE_SIZE]) >> 8;
+}
+
+
+
+static void
+spotlight_row (guchar        *dst,
+               const guchar  *src,
+               gint           n_bytes,
+               const guint16 *masks)
+{
+  gint k;
+
+  /* the alpha mask is 0, which keeps the alpha value */
+  for (k = 0; k < n_bytes; ++k)
+    dst[k] = masks[k % EXO_GDK_PIXBUF_TABLE_SIZE] ? lighten_channel (src[k]) : src[k];
+}
+
+
+
+static void
+lucent_row (guchar       *dst,
+            const guchar *src,
+            gint          width,
+            gint          n_channels,
+            guint         percent)
+{
+  guint alpha = (255u * percent) / 100u;
+  gint  j;
+
+  for (j = width; --j >= 0; )
     {
-      __m64 *pixdst = (__m64 *) gdk_pixbuf_get_pixels (dst);
-      __m64 *pixsrc = (__m64 *) gdk_pixbuf_get_pixels (source);
-      __m64  alpha_mask = _mm_set_pi8 (0xff, 0, 0, 0, 0xff, 0, 0, 0);
-      __m64  color_factor = _mm_set_pi16 (0, color->blue, color->green, color->red);
-      __m64  zero = _mm_setzero_si64 ();
-      __m64  src, alpha, hi, lo;
+      *dst++ = *src++;
+      *dst++ = *src++;
+      *dst++ = *src++;
 
-      /* divide color components by 256 */
-      color_factor = _mm_srli_pi16 (color_factor, 8);
+      /* scale the alpha channel or use a fixed alpha value */
+      if (G_LIKELY (n_channels == 4))
+        *dst++ = ((guint) *src++ * percent) / 100u;
+      else
+        *dst++ = alpha;
+    }
+}
 
-      for (i = (width * height) >> 1; i > 0; --i)
-        {
-          /* read the source pixel */
-          src = *pixsrc;
 
-          /* remember the two alpha values */
-          alpha = _mm_and_si64 (alpha_mask, src);
 
-          /* extract the hi pixel */
-          hi = _mm_unpackhi_pi8 (src, zero);
-          hi = _mm_mullo_pi16 (hi, color_factor);
+#ifdef EXO_GDK_PIXBUF_X86_KERNELS
+/* Divides the 16 bit values of x by 100: (x * 41944) >> 22 equals
+ * x / 100 for x up to 43698, and is off by one from 43699 on. The
+ * products of a channel and a percentage are at most 255 * 100.
+ */
+#define EXO_GDK_PIXBUF_DIV100_MAGIC (41944)
+#define EXO_GDK_PIXBUF_DIV100_MAX   (43698)
+
+G_STATIC_ASSERT (255 * 100 <= EXO_GDK_PIXBUF_DIV100_MAX);
 
-          /* extract the lo pixel */
-          lo = _mm_unpacklo_pi8 (src, zero);
-          lo = _mm_mullo_pi16 (lo, color_factor);
+static void __attribute__ ((target ("sse2")))
+colorize_row_sse2 (guchar        *dst,
+                   const guchar  *src,
+                   gint           n_bytes,
+                   const guint16 *factors)
+{
+  __m128i zero = _mm_setzero_si128 ();
+  __m128i pixels, lo, hi;
+  gint    k;
+
+  for (k = 0; k + 16 <= n_bytes; k += 16)
+    {
+      const guint16 *f = factors + (k % EXO_GDK_PIXBUF_TABLE_SIZE);
 
-          /* prefetch the next two pixels */
-          __builtin_prefetch (++pixsrc, 0, 1);
+      pixels = _mm_loadu_si128 ((const __m128i *) (src + k));
 
-          /* divide by 256 */
-          hi = _mm_srli_pi16 (hi, 8);
-          lo = _mm_srli_pi16 (lo, 8);
+      /* multiply the 16 bit channels with their factors and divide by 256 */
+      lo = _mm_unpacklo_epi8 (pixels, zero);
+      hi = _mm_unpackhi_epi8 (pixels, zero);
+      lo = _mm_srli_epi16 (_mm_mullo_epi16 (lo, _mm_loadu_si128 ((const __m128i *) f)), 8);
+      hi = _mm_srli_epi16 (_mm_mullo_epi16 (hi, _mm_loadu_si128 ((const __m128i *) (f + 8))), 8);
 
-          /* combine the 2 pixels again */
-          src = _mm_packs_pu16 (lo, hi);
+      _mm_storeu_si128 ((__m128i *) (dst + k), _mm_packus_epi16 (lo, hi));
+    }
+
+  /* the remaining bytes use the same table positions */
+  for (; k < n_bytes; ++k)
+    dst[k] = (src[k] * factors[k % EXO_GDK_PIXBUF_TABLE_SIZE]) >> 8;
+}
+
+
+
+static void __attribute__ ((target ("avx2")))
+colorize_row_avx2 (guchar        *dst,
+                   const guchar  *src,
+                   gint           n_bytes,
+                   const guint16 *factors)
+{
+  __m256i lo, hi;
+  gint    k;
+
+  for (k = 0; k + 32 <= n_bytes; k += 32)
+    {
+      const guint16 *f = factors + (k % EXO_GDK_PIXBUF_TABLE_SIZE);
 
-          /* write back the calculated color together with the alpha */
-          *pixdst = _mm_or_si64 (alpha, src);
+      /* widen the channels to 16 bits, keeping them in order */
+      lo = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (src + k)));
+      hi = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (src + k + 16)));
 
-          /* advance the dest pointer */
-          ++pixdst;
+      lo = _mm256_srli_epi16 (_mm256_mullo_epi16 (lo, _mm256_loadu_si256 ((const __m256i *) f)), 8);
+      hi = _mm256_srli_epi16 (_mm256_mullo_epi16 (hi, _mm256_loadu_si256 ((const __m256i *) (f + 16))), 8);
+
+      /* packing works per 128 bit lane, so restore the order afterwards */
+      _mm256_storeu_si256 ((__m256i *) (dst + k), _mm256_permute4x64_epi64 (_mm256_packus_epi16 (lo, hi), 0xd8));
+    }
+
+  for (; k < n_bytes; ++k)
+    dst[k] = (src[k] * factors[k % EXO_GDK_PIXBUF_TABLE_SIZE]) >> 8;
+}
+
+
+
+static void __attribute__ ((target ("sse2")))
+spotlight_row_sse2 (guchar        *dst,
+                    const guchar  *src,
+                    gint           n_bytes,
+                    const guint16 *masks)
+{
+  __m128i twentyfour = _mm_set1_epi16 (24);
+  __m128i zero = _mm_setzero_si128 ();
+  __m128i pixels, lo, hi;
+  gint    k;
+
+  for (k = 0; k + 16 <= n_bytes; k += 16)
+    {
+      const guint16 *m = masks + (k % EXO_GDK_PIXBUF_TABLE_SIZE);
+
+      pixels = _mm_loadu_si128 ((const __m128i *) (src + k));
+      lo = _mm_unpacklo_epi8 (pixels, zero);
+      hi = _mm_unpackhi_epi8 (pixels, zero);
+
+      /* add 24 + (x >> 3) to the color channels, the packing saturates */
+      lo = _mm_add_epi16 (lo, _mm_and_si128 (_mm_add_epi16 (_mm_srli_epi16 (lo, 3), twentyfour),
+                                             _mm_loadu_si128 ((const __m128i *) m)));
+      hi = _mm_add_epi16 (hi, _mm_and_si128 (_mm_add_epi16 (_mm_srli_epi16 (hi, 3), twentyfour),
+                                             _mm_loadu_si128 ((const __m128i *) (m + 8))));
+
+      _mm_storeu_si128 ((__m128i *) (dst + k), _mm_packus_epi16 (lo, hi));
+    }
+
+  for (; k < n_bytes; ++k)
+    dst[k] = masks[k % EXO_GDK_PIXBUF_TABLE_SIZE] ? lighten_channel (src[k]) : src[k];
+}
+
+
+
+static void __attribute__ ((target ("avx2")))
+spotlight_row_avx2 (guchar        *dst,
+                    const guchar  *src,
+                    gint           n_bytes,
+                    const guint16 *masks)
+{
+  __m256i twentyfour = _mm256_set1_epi16 (24);
+  __m256i lo, hi;
+  gint    k;
+
+  for (k = 0; k + 32 <= n_bytes; k += 32)
+    {
+      const guint16 *m = masks + (k % EXO_GDK_PIXBUF_TABLE_SIZE);
+
+      lo = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (src + k)));
+      hi = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (src + k + 16)));
+
+      lo = _mm256_add_epi16 (lo, _mm256_and_si256 (_mm256_add_epi16 (_mm256_srli_epi16 (lo, 3), twentyfour),
+                                                   _mm256_loadu_si256 ((const __m256i *) m)));
+      hi = _mm256_add_epi16 (hi, _mm256_and_si256 (_mm256_add_epi16 (_mm256_srli_epi16 (hi, 3), twentyfour),
+                                                   _mm256_loadu_si256 ((const __m256i *) (m + 16))));
+
+      _mm256_storeu_si256 ((__m256i *) (dst + k), _mm256_permute4x64_epi64 (_mm256_packus_epi16 (lo, hi), 0xd8));
+    }
+
+  for (; k < n_bytes; ++k)
+    dst[k] = masks[k % EXO_GDK_PIXBUF_TABLE_SIZE] ? lighten_channel (src[k]) : src[k];
+}
+
+
+
+static void __attribute__ ((target ("sse2")))
+lucent_row_sse2 (guchar       *dst,
+                 const guchar *src,
+                 gint          width,
+                 gint          n_channels,
+                 guint         percent)
+{
+  __m128i alpha_mask = _mm_set1_epi32 ((gint) 0xff000000u);
+  __m128i factor = _mm_set1_epi16 (percent);
+  __m128i magic = _mm_set1_epi16 ((gint16) EXO_GDK_PIXBUF_DIV100_MAGIC);
+  __m128i zero = _mm_setzero_si128 ();
+  __m128i pixels, lo, hi;
+  gint    j = 0;
+
+  /* the division by 100 is only exact for 255 * 100 at most */
+  _exo_assert (percent <= 100);
+
+  /* expanding RGB to RGBA needs byte shuffles, which SSE2 lacks */
+  if (G_LIKELY (n_channels == 4))
+    {
+      for (; j + 4 <= width; j += 4)
+        {
+          pixels = _mm_loadu_si128 ((const __m128i *) (src + 4 * j));
+
+          /* calculate (x * percent) / 100 for all channels */
+          lo = _mm_mullo_epi16 (_mm_unpacklo_epi8 (pixels, zero), factor);
+          hi = _mm_mullo_epi16 (_mm_unpackhi_epi8 (pixels, zero), factor);
+          lo = _mm_srli_epi16 (_mm_mulhi_epu16 (lo, magic), 6);
+          hi = _mm_srli_epi16 (_mm_mulhi_epu16 (hi, magic), 6);
+
+          /* but keep the color channels */
+          pixels = _mm_or_si128 (_mm_andnot_si128 (alpha_mask, pixels),
+                                 _mm_and_si128 (alpha_mask, _mm_packus_epi16 (lo, hi)));
+
+          _mm_storeu_si128 ((__m128i *) (dst + 4 * j), pixels);
         }
+    }
 
-      _mm_empty ();
+  lucent_row (dst + 4 * j, src + n_channels * j, width - j, n_channels, percent);
+}
+
+
+
+static void __attribute__ ((target ("avx2")))
+lucent_row_avx2 (guchar       *dst,
+                 const guchar *src,
+                 gint          width,
+                 gint          n_channels,
+                 guint         percent)
+{
+  __m256i alpha_mask = _mm256_set1_epi32 ((gint) 0xff000000u);
+  __m256i factor = _mm256_set1_epi16 (percent);
+  __m256i magic = _mm256_set1_epi16 ((gint16) EXO_GDK_PIXBUF_DIV100_MAGIC);
+  __m256i pixels, lo, hi;
+  __m128i expand, alpha, rgb;
+  gint    j = 0;
+
+  /* the division by 100 is only exact for 255 * 100 at most */
+  _exo_assert (percent <= 100);
+
+  if (G_LIKELY (n_channels == 4))
+    {
+      for (; j + 8 <= width; j += 8)
+        {
+          pixels = _mm256_loadu_si256 ((const __m256i *) (src + 4 * j));
+
+          lo = _mm256_mullo_epi16 (_mm256_cvtepu8_epi16 (_mm256_castsi256_si128 (pixels)), factor);
+          hi = _mm256_mullo_epi16 (_mm256_cvtepu8_epi16 (_mm256_extracti128_si256 (pixels, 1)), factor);
+          lo = _mm256_srli_epi16 (_mm256_mulhi_epu16 (lo, magic), 6);
+          hi = _mm256_srli_epi16 (_mm256_mulhi_epu16 (hi, magic), 6);
+
+          pixels = _mm256_or_si256 (_mm256_andnot_si256 (alpha_mask, pixels),
+                                    _mm256_and_si256 (alpha_mask, _mm256_permute4x64_epi64 (_mm256_packus_epi16 (lo, hi), 0xd8)));
+
+          _mm256_storeu_si256 ((__m256i *) (dst + 4 * j), pixels);
+        }
     }
   else
+    {
+      /* spread 4 RGB pixels to RGBA and insert the fixed alpha value */
+      expand = _mm_setr_epi8 (0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+      alpha = _mm_set1_epi32 ((gint) (((255u * percent) / 100u) << 24));
+
+      /* each load reads 16 bytes, of which only 12 are used */
+      for (; 3 * j + 16 <= 3 * width; j += 4)
+        {
+          rgb = _mm_loadu_si128 ((const __m128i *) (src + 3 * j));
+          _mm_storeu_si128 ((__m128i *) (dst + 4 * j), _mm_or_si128 (_mm_shuffle_epi8 (rgb, expand), alpha));
+        }
+    }
+
+  lucent_row (dst + 4 * j, src + n_channels * j, width - j, n_channels, percent);
+}
+#endif
+
+
+
+static ExoGdkPixbufColorizeFunc  colorize_row_func;
+static ExoGdkPixbufSpotlightFunc spotlight_row_func;
+static ExoGdkPixbufLucentFunc    lucent_row_func;
+
+
+
+static void
+exo_gdk_pixbuf_init_kernels (void)
+{
+  static gsize initialized = 0;
+#ifdef EXO_GDK_PIXBUF_X86_KERNELS
+  const gchar *kernels;
 #endif
+
+  if (g_once_init_enter (&initialized))
     {
-      guchar *dst_pixels = gdk_pixbuf_get_pixels (dst);
-      guchar *src_pixels = gdk_pixbuf_get_pixels (source);
-      guchar *pixdst;
-      guchar *pixsrc;
-      gint    red_value = color->red / 255.0;
-      gint    green_value = color->green / 255.0;
-      gint    blue_value = color->blue / 255.0;
-      gint    j;
-
-      for (i = height; --i >= 0; )
+      /* the scalar kernels are the reference implementation */
+      colorize_row_func = colorize_row;
+      spotlight_row_func = spotlight_row;
+      lucent_row_func = lucent_row;
+
+#ifdef EXO_GDK_PIXBUF_X86_KERNELS
+      /* EXO_GDK_PIXBUF_KERNELS may limit the kernels to "scalar" or
+       * "sse2", which the tests use to compare them with the reference
+       */
+      kernels = g_getenv ("EXO_GDK_PIXBUF_KERNELS");
+
+      /* pick the best kernels the CPU supports */
+      __builtin_cpu_init ();
+      if (__builtin_cpu_supports ("avx2") && (kernels == NULL || strcmp (kernels, "avx2") == 0))
+        {
+          colorize_row_func = colorize_row_avx2;
+          spotlight_row_func = spotlight_row_avx2;
+          lucent_row_func = lucent_row_avx2;
+        }
+      else if (__builtin_cpu_supports ("sse2") && (kernels == NULL || strcmp (kernels, "scalar") != 0))
         {
-          pixdst = dst_pixels + i * dst_row_stride;
-          pixsrc = src_pixels + i * src_row_stride;
+          colorize_row_func = colorize_row_sse2;
+          spotlight_row_func = spotlight_row_sse2;
+          lucent_row_func = lucent_row_sse2;
+        }
+#endif
+
+      g_once_init_leave (&initialized, 1);
+    }
+}
 
-          for (j = width; j > 0; --j)
-            {
-              *pixdst++ = (*pixsrc++ * red_value) >> 8;
-              *pixdst++ = (*pixsrc++ * green_value) >> 8;
-              *pixdst++ = (*pixsrc++ * blue_value) >> 8;
 
-              if (has_alpha)
-                *pixdst++ = *pixsrc++;
+static gboolean
+exo_gdk_pixbuf_is_compatible (const GdkPixbuf *source,
+                              const GdkPixbuf *dest)
+{
+  gint src_n_channels = gdk_pixbuf_get_n_channels (source);
+  gint dst_n_channels = gdk_pixbuf_get_n_channels (dest);
+
+  /* the destination must match the source, but may add an alpha channel */
+  return gdk_pixbuf_get_width (source) == gdk_pixbuf_get_width (dest)
+      && gdk_pixbuf_get_height (source) == gdk_pixbuf_get_height (dest)
+      && gdk_pixbuf_get_colorspace (source) == gdk_pixbuf_get_colorspace (dest)
+      && gdk_pixbuf_get_bits_per_sample (source) == gdk_pixbuf_get_bits_per_sample (dest)
+      && (src_n_channels == dst_n_channels || (src_n_channels == 3 && dst_n_channels == 4));
+}
+
+
+
+static void
+exo_gdk_pixbuf_apply (const GdkPixbuf   *source,
+                      GdkPixbuf         *dest,
+                      ExoGdkPixbufEffect effects,
+                      const GdkColor    *color,
+                      guint              percent)
+{
+  const guchar *src_row;
+  guint16       factors[EXO_GDK_PIXBUF_TABLE_SIZE];
+  guint16       masks[EXO_GDK_PIXBUF_TABLE_SIZE];
+  guchar       *dst_pixels;
+  guchar       *src_pixels;
+  guchar       *dst_row;
+  gint          dst_row_stride;
+  gint          src_row_stride;
+  gint          dst_n_channels;
+  gint          src_n_channels;
+  gint          n_bytes;
+  gint          width;
+  gint          height;
+  gint          i;
+
+  /* determine source parameters */
+  width = gdk_pixbuf_get_width (source);
+  height = gdk_pixbuf_get_height (source);
+
+  /* determine row strides on src/dst */
+  dst_row_stride = gdk_pixbuf_get_rowstride (dest);
+  src_row_stride = gdk_pixbuf_get_rowstride (source);
+
+  /* determine pixels on src/dst */
+  dst_pixels = gdk_pixbuf_get_pixels (dest);
+  src_pixels = gdk_pixbuf_get_pixels (source);
+
+  /* the tables are setup for the destination layout */
+  dst_n_channels = gdk_pixbuf_get_n_channels (dest);
+  src_n_channels = gdk_pixbuf_get_n_channels (source);
+  n_bytes = width * dst_n_channels;
+
+  /* setup the factors for the byte positions, keeping the alpha channel */
+  if ((effects & EXO_GDK_PIXBUF_EFFECT_COLORIZE) != 0)
+    {
+      for (i = 0; i < EXO_GDK_PIXBUF_TABLE_SIZE; ++i)
+        {
+          switch (i % dst_n_channels)
+            {
+            case 0:  factors[i] = color->red / 255.0;   break;
+            case 1:  factors[i] = color->green / 255.0; break;
+            case 2:  factors[i] = color->blue / 255.0;  break;
+            default: factors[i] = 256;                  break;
             }
         }
     }
 
+  /* lighten the color channels only */
+  if ((effects & EXO_GDK_PIXBUF_EFFECT_SPOTLIGHT) != 0)
+    {
+      for (i = 0; i < EXO_GDK_PIXBUF_TABLE_SIZE; ++i)
+        masks[i] = (i % dst_n_channels < 3) ? 0xffff : 0;
+    }
+
+  exo_gdk_pixbuf_init_kernels ();
+
+  /* apply all effects to a row before moving on to the next one,
+   * so the source pixels are read from memory only once.
+   */
+  for (i = 0; i < height; ++i)
+    {
+      src_row = src_pixels + i * src_row_stride;
+      dst_row = dst_pixels + i * dst_row_stride;
+
+      /* add an opaque alpha channel if the source lacks one */
+      if (G_UNLIKELY (src_n_channels != dst_n_channels))
+        {
+          (*lucent_row_func) (dst_row, src_row, width, src_n_channels, 100);
+          src_row = dst_row;
+        }
+
+      if ((effects & EXO_GDK_PIXBUF_EFFECT_COLORIZE) != 0)
+        {
+          (*colorize_row_func) (dst_row, src_row, n_bytes, factors);
+          src_row = dst_row;
+        }
+
+      if ((effects & EXO_GDK_PIXBUF_EFFECT_SPOTLIGHT) != 0)
+        {
+          (*spotlight_row_func) (dst_row, src_row, n_bytes, masks);
+          src_row = dst_row;
+        }
+
+      if ((effects & EXO_GDK_PIXBUF_EFFECT_LUCENT) != 0)
+        {
+          (*lucent_row_func) (dst_row, src_row, width, dst_n_channels, percent);
+          src_row = dst_row;
+        }
+
+      /* copy the row if no effect was applied */
+      if (G_UNLIKELY (src_row != dst_row))
+        memcpy (dst_row, src_row, n_bytes);
+    }
+}
+
+
+
+
+
+/**
+ * exo_gdk_pixbuf_colorize:
+ * @source : the source #GdkPixbuf.
+ * @color  : the new color.
+ *
+ * Creates a new #GdkPixbuf based on @source, which is
+ * colorized to @color.
+ *
+ * The caller is responsible to free the returned object
+ * using g_object_unref() when no longer needed.
+ *
+ * Returns: the colorized #GdkPixbuf.
+ *
+ * Since: 0.3.1.3
+ **/
+GdkPixbuf*
+exo_gdk_pixbuf_colorize (const GdkPixbuf *source,
+                         const GdkColor  *color)
+{
+  GdkPixbuf *dst;
+
+  /* allocate the destination pixbuf */
+  dst = gdk_pixbuf_new (gdk_pixbuf_get_colorspace (source), gdk_pixbuf_get_has_alpha (source),
+                        gdk_pixbuf_get_bits_per_sample (source), gdk_pixbuf_get_width (source),
+                        gdk_pixbuf_get_height (source));
+
+  exo_gdk_pixbuf_apply (source, dst, EXO_GDK_PIXBUF_EFFECT_COLORIZE, color, 100);
+
   return dst;
 }
 
@@ -352,90 +769,22 @@ exo_gdk_pixbuf_lucent (const GdkPixbuf *source,
                        guint            percent)
 {
   GdkPixbuf *dst;
-  guchar    *dst_pixels;
-  guchar    *src_pixels;
-  guchar    *pixdst;
-  guchar    *pixsrc;
-  gint       dst_row_stride;
-  gint       src_row_stride;
-  gint       width;
-  gint       height;
-  gint       i, j;
 
   g_return_val_if_fail (GDK_IS_PIXBUF (source), NULL);
   g_return_val_if_fail ((gint) percent >= 0 && percent <= 100, NULL);
 
-  /* determine source parameters */
-  width = gdk_pixbuf_get_width (source);
-  height = gdk_pixbuf_get_height (source);
-
-  /* allocate the destination pixbuf */
-  dst = gdk_pixbuf_new (gdk_pixbuf_get_colorspace (source), TRUE, gdk_pixbuf_get_bits_per_sample (source), width, height);
-
-  /* determine row strides on src/dst */
-  dst_row_stride = gdk_pixbuf_get_rowstride (dst);
-  src_row_stride = gdk_pixbuf_get_rowstride (source);
-
-  /* determine pixels on src/dst */
-  dst_pixels = gdk_pixbuf_get_pixels (dst);
-  src_pixels = gdk_pixbuf_get_pixels (source);
-
-  /* check if the source already contains an alpha channel */
-  if (G_LIKELY (gdk_pixbuf_get_has_alpha (source)))
-    {
-      for (i = height; --i >= 0; )
-        {
-          pixdst = dst_pixels + i * dst_row_stride;
-          pixsrc = src_pixels + i * src_row_stride;
+  /* allocate the destination pixbuf, which always contains an alpha channel */
+  dst = gdk_pixbuf_new (gdk_pixbuf_get_colorspace (source), TRUE,
+                        gdk_pixbuf_get_bits_per_sample (source), gdk_pixbuf_get_width (source),
+                        gdk_pixbuf_get_height (source));
 
-          for (j = width; --j >= 0; )
-            {
-              *pixdst++ = *pixsrc++;
-              *pixdst++ = *pixsrc++;
-              *pixdst++ = *pixsrc++;
-              *pixdst++ = ((guint) *pixsrc++ * percent) / 100u;
-            }
-        }
-    }
-  else
-    {
-      /* pre-calculate the alpha value */
-      percent = (255u * percent) / 100u;
-
-      for (i = height; --i >= 0; )
-        {
-          pixdst = dst_pixels + i * dst_row_stride;
-          pixsrc = src_pixels + i * src_row_stride;
-
-          for (j = width; --j >= 0; )
-            {
-              *pixdst++ = *pixsrc++;
-              *pixdst++ = *pixsrc++;
-              *pixdst++ = *pixsrc++;
-              *pixdst++ = percent;
-            }
-        }
-    }
+  exo_gdk_pixbuf_apply (source, dst, EXO_GDK_PIXBUF_EFFECT_LUCENT, NULL, percent);
 
   return dst;
 }
 
 
 
-static inline guchar
-lighten_channel (guchar cur_value)
-{
-  gint new_value = cur_value;
-
-  new_value += 24 + (new_value >> 3);
-  if (G_UNLIKELY (new_value > 255))
-    new_value = 255;
-
-  return (guchar) new_value;
-}
-
-
-
 /**
  * exo_gdk_pixbuf_spotlight:
  * @source : the source #GdkPixbuf.
@@ -454,101 +803,55 @@ GdkPixbuf*
 exo_gdk_pixbuf_spotlight (const GdkPixbuf *source)
 {
   GdkPixbuf *dst;
-  gboolean   has_alpha;
-  gint       dst_row_stride;
-  gint       src_row_stride;
-  gint       width;
-  gint       height;
-  gint       i;
-
-  /* determine source parameters */
-  width = gdk_pixbuf_get_width (source);
-  height = gdk_pixbuf_get_height (source);
-  has_alpha = gdk_pixbuf_get_has_alpha (source);
 
   /* allocate the destination pixbuf */
-  dst = gdk_pixbuf_new (gdk_pixbuf_get_colorspace (source), has_alpha, gdk_pixbuf_get_bits_per_sample (source), width, height);
-
-  /* determine src/dst row strides */
-  dst_row_stride = gdk_pixbuf_get_rowstride (dst);
-  src_row_stride = gdk_pixbuf_get_rowstride (source);
-
-#if defined(__GNUC__) && defined(__MMX__)
-  /* check if there's a good reason to use MMX */
-  if (G_LIKELY (has_alpha && dst_row_stride == width * 4 && src_row_stride == width * 4 && (width * height) % 2 == 0))
-    {
-      __m64 *pixdst = (__m64 *) gdk_pixbuf_get_pixels (dst);
-      __m64 *pixsrc = (__m64 *) gdk_pixbuf_get_pixels (source);
-      __m64  alpha_mask = _mm_set_pi8 (0xff, 0, 0, 0, 0xff, 0, 0, 0);
-      __m64  twentyfour = _mm_set_pi8 (0, 24, 24, 24, 0, 24, 24, 24);
-      __m64  zero = _mm_setzero_si64 ();
-
-      for (i = (width * height) >> 1; i > 0; --i)
-        {
-          /* read the source pixel */
-          __m64 src = *pixsrc;
-
-          /* remember the two alpha values */
-          __m64 alpha = _mm_and_si64 (alpha_mask, src);
-
-          /* extract the hi pixel */
-          __m64 hi = _mm_unpackhi_pi8 (src, zero);
-
-          /* extract the lo pixel */
-          __m64 lo = _mm_unpacklo_pi8 (src, zero);
-
-          /* add (x >> 3) to x */
-          hi = _mm_adds_pu16 (hi, _mm_srli_pi16 (hi, 3));
-          lo = _mm_adds_pu16 (lo, _mm_srli_pi16 (lo, 3));
-
-          /* prefetch next value */
-          __builtin_prefetch (++pixsrc, 0, 1);
-
-          /* combine the two pixels again */
-          src = _mm_packs_pu16 (lo, hi);
-
-          /* add 24 (with saturation) */
-          src = _mm_adds_pu8 (src, twentyfour);
-
-          /* drop the alpha channel from the temp color */
-          src = _mm_andnot_si64 (alpha_mask, src);
-
-          /* write back the calculated color */
-          *pixdst = _mm_or_si64 (alpha, src);
-
-          /* advance the dest pointer */
-          ++pixdst;
-        }
+  dst = gdk_pixbuf_new (gdk_pixbuf_get_colorspace (source), gdk_pixbuf_get_has_alpha (source),
+                        gdk_pixbuf_get_bits_per_sample (source), gdk_pixbuf_get_width (source),
+                        gdk_pixbuf_get_height (source));
 
-      _mm_empty ();
-    }
-  else
-#endif
-    {
-      guchar *dst_pixels = gdk_pixbuf_get_pixels (dst);
-      guchar *src_pixels = gdk_pixbuf_get_pixels (source);
-      guchar *pixdst;
-      guchar *pixsrc;
-      gint    j;
+  exo_gdk_pixbuf_apply (source, dst, EXO_GDK_PIXBUF_EFFECT_SPOTLIGHT, NULL, 100);
 
-      for (i = height; --i >= 0; )
-        {
-          pixdst = dst_pixels + i * dst_row_stride;
-          pixsrc = src_pixels + i * src_row_stride;
+  return dst;
+}
 
-          for (j = width; j > 0; --j)
-            {
-              *pixdst++ = lighten_channel (*pixsrc++);
-              *pixdst++ = lighten_channel (*pixsrc++);
-              *pixdst++ = lighten_channel (*pixsrc++);
 
-              if (G_LIKELY (has_alpha))
-                *pixdst++ = *pixsrc++;
-            }
-        }
-    }
 
-  return dst;
+/**
+ * exo_gdk_pixbuf_apply_effects:
+ * @source  : the source #GdkPixbuf.
+ * @dest    : the destination #GdkPixbuf, which may be @source.
+ * @effects : the #ExoGdkPixbufEffect flags to apply.
+ * @color   : the color for %EXO_GDK_PIXBUF_EFFECT_COLORIZE or %NULL.
+ * @percent : the percentage for %EXO_GDK_PIXBUF_EFFECT_LUCENT.
+ *
+ * Applies the @effects to @source in a single pass and writes
+ * the result to @dest, without allocating any memory. The effects
+ * are applied in the order colorize, spotlight and lucent, which
+ * gives the same result as chaining exo_gdk_pixbuf_colorize(),
+ * exo_gdk_pixbuf_spotlight() and exo_gdk_pixbuf_lucent().
+ *
+ * @dest must have the same size and format as @source, except that
+ * it may add an alpha channel, which is required for
+ * %EXO_GDK_PIXBUF_EFFECT_LUCENT. If @dest is @source, the effects
+ * are applied in-place.
+ *
+ * Since: 4.16
+ **/
+void
+exo_gdk_pixbuf_apply_effects (const GdkPixbuf   *source,
+                              GdkPixbuf         *dest,
+                              ExoGdkPixbufEffect effects,
+                              const GdkColor    *color,
+                              guint              percent)
+{
+  g_return_if_fail (GDK_IS_PIXBUF (source));
+  g_return_if_fail (GDK_IS_PIXBUF (dest));
+  g_return_if_fail (exo_gdk_pixbuf_is_compatible (source, dest));
+  g_return_if_fail ((effects & EXO_GDK_PIXBUF_EFFECT_COLORIZE) == 0 || color != NULL);
+  g_return_if_fail ((effects & EXO_GDK_PIXBUF_EFFECT_LUCENT) == 0 || gdk_pixbuf_get_has_alpha (dest));
+  g_return_if_fail (percent <= 100);
+
+  exo_gdk_pixbuf_apply (source, dest, effects, color, percent);
 }
 
 
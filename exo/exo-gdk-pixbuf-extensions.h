@@ -32,6 +32,23 @@
 
 G_BEGIN_DECLS
 
+/**
+ * ExoGdkPixbufEffect:
+ * @EXO_GDK_PIXBUF_EFFECT_COLORIZE  : colorize like exo_gdk_pixbuf_colorize().
+ * @EXO_GDK_PIXBUF_EFFECT_SPOTLIGHT : lighten like exo_gdk_pixbuf_spotlight().
+ * @EXO_GDK_PIXBUF_EFFECT_LUCENT    : change the translucency like exo_gdk_pixbuf_lucent().
+ *
+ * Specifies the effects applied by exo_gdk_pixbuf_apply_effects().
+ *
+ * Since: 4.16
+ **/
+typedef enum
+{
+  EXO_GDK_PIXBUF_EFFECT_COLORIZE  = 1 << 0,
+  EXO_GDK_PIXBUF_EFFECT_SPOTLIGHT = 1 << 1,
+  EXO_GDK_PIXBUF_EFFECT_LUCENT    = 1 << 2
+} ExoGdkPixbufEffect;
+
 GdkPixbuf *exo_gdk_pixbuf_colorize                  (const GdkPixbuf *source,
                                                      const GdkColor  *color) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
 
@@ -47,6 +64,12 @@ GdkPixbuf *exo_gdk_pixbuf_lucent                    (const GdkPixbuf *source,
 
 GdkPixbuf *exo_gdk_pixbuf_spotlight                 (const GdkPixbuf *source) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
 
+void       exo_gdk_pixbuf_apply_effects             (const GdkPixbuf   *source,
+                                                     GdkPixbuf         *dest,
+                                                     ExoGdkPixbufEffect effects,
+                                                     const GdkColor    *color,
+                                                     guint              percent);
+
 GdkPixbuf *exo_gdk_pixbuf_scale_down                (GdkPixbuf       *source,
                                                      gboolean         preserve_aspect_ratio,
                                                      gint             dest_width,
@@ -249,8 +249,8 @@ exo_icon_chooser_dialog_init (ExoIconChooserDialog *icon_chooser_dialog)
   gtk_container_add (GTK_CONTAINER (scrolled_window), priv->icon_chooser);
   gtk_widget_show (priv->icon_chooser);
 
-  /* setup the icon renderer */
-  renderer = exo_cell_renderer_icon_new ();
+  /* setup the icon renderer, loading the icons in the background */
+  renderer = g_object_new (EXO_TYPE_CELL_RENDERER_ICON, "async", TRUE, NULL);
   gtk_cell_layout_pack_start (GTK_CELL_LAYOUT (priv->icon_chooser), renderer, TRUE);
   gtk_cell_layout_set_attributes (GTK_CELL_LAYOUT (priv->icon_chooser), renderer, "icon", EXO_ICON_CHOOSER_MODEL_COLUMN_ICON_NAME, NULL);
 
@@ -53,7 +53,7 @@ typedef struct
   guint action_idle_handler;
 } ExoIconViewItemAccessible;
 
-#define accessible_item_index(item) (g_list_index (EXO_ICON_VIEW (item->widget)->priv->items, item->item))
+#define accessible_item_index(item) ((item)->item != NULL ? (item)->item->index : -1)
 
 static const gchar *const exo_icon_view_item_accessible_action_names[] =
 {
@@ -83,7 +83,7 @@ exo_icon_view_item_accessible_idle_do_action (gpointer data)
   item = EXO_ICON_VIEW_ITEM_ACCESSIBLE (data);
   item->action_idle_handler = 0;
 
-  if (item->widget != NULL)
+  if (item->widget != NULL && item->item != NULL)
     {
       icon_view = EXO_ICON_VIEW (item->widget);
       path = gtk_tree_path_new_from_indices (accessible_item_index (item), -1);
@@ -219,6 +219,8 @@ get_pixbuf_box (ExoIconView     *icon_view,
   gint n;
   GParamSpec *pspec;
 
+  exo_icon_view_refine_item (icon_view, item);
+
   for (l = icon_view->priv->cell_list, n = 0; l; l = l->next, n++)
     {
       ExoIconViewCellInfo *info = l->data;
@@ -772,7 +774,7 @@ exo_icon_view_item_accessible_grab_focus (AtkComponent *component)
   g_return_val_if_fail (EXO_IS_ICON_VIEW_ITEM_ACCESSIBLE (component), FALSE);
 
   item = EXO_ICON_VIEW_ITEM_ACCESSIBLE (component);
-  if (!GTK_IS_WIDGET (item->widget))
+  if (!GTK_IS_WIDGET (item->widget) || item->item == NULL)
     return FALSE;
 
   gtk_widget_grab_focus (item->widget);
@@ -893,8 +895,14 @@ exo_icon_view_item_accessible_set_visibility (ExoIconViewItemAccessible *item,
                                               gboolean                   emit_signal)
 {
   if (exo_icon_view_item_accessible_is_showing (item))
-    return exo_icon_view_item_accessible_add_state (item, ATK_STATE_SHOWING,
-                                                    emit_signal);
+    {
+      /* only notify about actual changes */
+      if (atk_state_set_contains_state (item->state_set, ATK_STATE_SHOWING))
+        return FALSE;
+
+      return exo_icon_view_item_accessible_add_state (item, ATK_STATE_SHOWING,
+                                                      emit_signal);
+    }
   else
     return exo_icon_view_item_accessible_remove_state (item, ATK_STATE_SHOWING,
                                                        emit_signal);
@@ -992,11 +1000,11 @@ exo_icon_view_item_accessible_ref_state_set (AtkObject *obj)
     return NULL;
 
   icon_view = EXO_ICON_VIEW (item->widget);
-  if (icon_view->priv->cursor_item == item->item)
+  if (item->item != NULL && icon_view->priv->cursor_item == item->item)
     atk_state_set_add_state (item->state_set, ATK_STATE_FOCUSED);
   else
     atk_state_set_remove_state (item->state_set, ATK_STATE_FOCUSED);
-  if (item->item->selected)
+  if (item->item != NULL && EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item->item))
     atk_state_set_add_state (item->state_set, ATK_STATE_SELECTED);
   else
     atk_state_set_remove_state (item->state_set, ATK_STATE_SELECTED);
@@ -1094,13 +1102,12 @@ typedef struct
 
 typedef struct
 {
-  AtkObject *item;
-  gint       index;
-} ExoIconViewItemAccessibleInfo;
+  /* the item accessibles by row, NULL for rows without one */
+  GPtrArray *items;
 
-typedef struct
-{
-  GList *items;
+  /* the rows that may have items with ATK_STATE_SHOWING */
+  gint showing_first;
+  gint showing_last;
 
   GtkAdjustment *old_hadj;
   GtkAdjustment *old_vadj;
@@ -1115,34 +1122,6 @@ exo_icon_view_accessible_get_priv (AtkObject *accessible)
                              accessible_private_data_quark);
 }
 
-static void
-exo_icon_view_item_accessible_info_new (AtkObject *accessible,
-                                        AtkObject *item,
-                                        gint       idx)
-{
-  ExoIconViewItemAccessibleInfo *info;
-  ExoIconViewItemAccessibleInfo *tmp_info;
-  ExoIconViewAccessiblePrivate *priv;
-  GList *items;
-
-  info = g_new (ExoIconViewItemAccessibleInfo, 1);
-  info->item = item;
-  info->index = idx;
-
-  priv = exo_icon_view_accessible_get_priv (accessible);
-  items = priv->items;
-  while (items)
-    {
-      tmp_info = items->data;
-      if (tmp_info->index > idx)
-        break;
-      items = items->next;
-    }
-  priv->items = g_list_insert_before (priv->items, items, info);
-  priv->old_hadj = NULL;
-  priv->old_vadj = NULL;
-}
-
 static gint
 exo_icon_view_accessible_get_n_children (AtkObject *accessible)
 {
@@ -1155,7 +1134,7 @@ exo_icon_view_accessible_get_n_children (AtkObject *accessible)
 
   icon_view = EXO_ICON_VIEW (widget);
 
-  return g_list_length (icon_view->priv->items);
+  return EXO_ICON_VIEW_N_ITEMS (icon_view);
 }
 
 static AtkObject *
@@ -1163,29 +1142,21 @@ exo_icon_view_accessible_find_child (AtkObject *accessible,
                                      gint       idx)
 {
   ExoIconViewAccessiblePrivate *priv;
-  ExoIconViewItemAccessibleInfo *info;
-  GList *items;
 
   priv = exo_icon_view_accessible_get_priv (accessible);
-  items = priv->items;
+  if (idx < 0 || idx >= (gint) priv->items->len)
+    return NULL;
 
-  while (items)
-    {
-      info = items->data;
-      if (info->index == idx)
-        return info->item;
-      items = items->next;
-    }
-  return NULL;
+  return g_ptr_array_index (priv->items, idx);
 }
 
 static AtkObject *
 exo_icon_view_accessible_ref_child (AtkObject *accessible,
                                     gint       idx)
 {
+  ExoIconViewAccessiblePrivate *priv;
   ExoIconView *icon_view;
   GtkWidget *widget;
-  GList *icons;
   AtkObject *obj;
   ExoIconViewItemAccessible *a11y_item;
 
@@ -1193,24 +1164,24 @@ exo_icon_view_accessible_ref_child (AtkObject *accessible,
   if (!widget)
     return NULL;
 
+  priv = exo_icon_view_accessible_get_priv (accessible);
+
   icon_view = EXO_ICON_VIEW (widget);
-  icons = g_list_nth (icon_view->priv->items, idx);
   obj = NULL;
-  if (icons)
+  if (idx >= 0 && idx < EXO_ICON_VIEW_N_ITEMS (icon_view))
     {
-      ExoIconViewItem *item = icons->data;
-      gint item_index = g_list_index (icon_view->priv->items, item);
+      ExoIconViewItem *item = EXO_ICON_VIEW_NTH_ITEM (icon_view, idx);
 
-      g_return_val_if_fail (item_index == idx, NULL);
+      g_return_val_if_fail (item->index == idx, NULL);
       obj = exo_icon_view_accessible_find_child (accessible, idx);
       if (!obj)
         {
           gchar *text;
 
           obj = g_object_new (exo_icon_view_item_accessible_get_type (), NULL);
-          exo_icon_view_item_accessible_info_new (accessible,
-                                                  obj,
-                                                  idx);
+          if (idx >= (gint) priv->items->len)
+            g_ptr_array_set_size (priv->items, idx + 1);
+          g_ptr_array_index (priv->items, idx) = obj;
           obj->role = ATK_ROLE_ICON;
           a11y_item = EXO_ICON_VIEW_ITEM_ACCESSIBLE (obj);
           a11y_item->item = item;
@@ -1226,6 +1197,20 @@ exo_icon_view_accessible_ref_child (AtkObject *accessible,
             }
 
           exo_icon_view_item_accessible_set_visibility (a11y_item, FALSE);
+          if (atk_state_set_contains_state (a11y_item->state_set, ATK_STATE_SHOWING))
+            {
+              /* the item must be checked again when the viewport changes */
+              if (priv->showing_first < priv->showing_last)
+                {
+                  priv->showing_first = MIN (priv->showing_first, idx);
+                  priv->showing_last = MAX (priv->showing_last, idx + 1);
+                }
+              else
+                {
+                  priv->showing_first = idx;
+                  priv->showing_last = idx + 1;
+                }
+            }
           g_object_add_weak_pointer (G_OBJECT (widget), (gpointer) &(a11y_item->widget));
        }
       g_object_ref (obj);
@@ -1234,41 +1219,93 @@ exo_icon_view_accessible_ref_child (AtkObject *accessible,
 }
 
 static void
-exo_icon_view_accessible_traverse_items (ExoIconViewAccessible *view,
-                                         GList                 *list)
+exo_icon_view_accessible_update_visibility (ExoIconViewAccessiblePrivate *priv,
+                                            gint                          first,
+                                            gint                          last,
+                                            gint                         *showing_first,
+                                            gint                         *showing_last)
 {
-  ExoIconViewAccessiblePrivate *priv;
-  ExoIconViewItemAccessibleInfo *info;
   ExoIconViewItemAccessible *item;
-  GList *items;
+  gint n;
 
-  priv =  exo_icon_view_accessible_get_priv (ATK_OBJECT (view));
-  if (priv->items)
+  last = MIN (last, (gint) priv->items->len);
+  for (n = MAX (first, 0); n < last; ++n)
     {
-      GtkWidget *widget;
-      gboolean act_on_item;
+      item = g_ptr_array_index (priv->items, n);
+      if (item == NULL)
+        continue;
 
-      widget = gtk_accessible_get_widget (GTK_ACCESSIBLE (view));
-      if (widget == NULL)
-        return;
+      exo_icon_view_item_accessible_set_visibility (item, TRUE);
+      if (atk_state_set_contains_state (item->state_set, ATK_STATE_SHOWING))
+        {
+          *showing_first = MIN (*showing_first, n);
+          *showing_last = MAX (*showing_last, n + 1);
+        }
+    }
+}
 
-      items = priv->items;
+static void
+exo_icon_view_accessible_traverse_items (ExoIconViewAccessible *view,
+                                         gint                   extend)
+{
+  ExoIconViewAccessiblePrivate *priv;
+  GtkAllocation allocation;
+  ExoIconView *icon_view;
+  GtkWidget *widget;
+  gint showing_first = G_MAXINT;
+  gint showing_last = 0;
+  gint first, last;
+  gint visible_first;
+  gint visible_last;
+  gint start, size;
+
+  priv = exo_icon_view_accessible_get_priv (ATK_OBJECT (view));
+  if (priv->items->len == 0)
+    return;
 
-      act_on_item = (list == NULL);
+  widget = gtk_accessible_get_widget (GTK_ACCESSIBLE (view));
+  if (widget == NULL)
+    return;
 
-      while (items)
-        {
-          info = (ExoIconViewItemAccessibleInfo *)items->data;
-          item = EXO_ICON_VIEW_ITEM_ACCESSIBLE (info->item);
+  icon_view = EXO_ICON_VIEW (widget);
 
-          if (act_on_item == FALSE && list == items)
-            act_on_item = TRUE;
+  /* update the items that may have left the viewport, extended by the
+   * number of rows the items moved since */
+  first = priv->showing_first - extend;
+  last = priv->showing_last + extend;
+  if (priv->showing_first < priv->showing_last)
+    exo_icon_view_accessible_update_visibility (priv, first, last, &showing_first, &showing_last);
+  else
+    first = last = 0;
 
-          if (act_on_item)
-            exo_icon_view_item_accessible_set_visibility (item, TRUE);
+  /* determine the items on the lines in the visible rectangle of
+   * exo_icon_view_item_accessible_is_showing(), including its edges */
+  gtk_widget_get_allocation (widget, &allocation);
+  if (G_LIKELY (icon_view->priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
+    {
+      start = (icon_view->priv->vadjustment != NULL) ? (gint) gtk_adjustment_get_value (icon_view->priv->vadjustment) : 0;
+      size = allocation.height;
+    }
+  else
+    {
+      start = (icon_view->priv->hadjustment != NULL) ? (gint) gtk_adjustment_get_value (icon_view->priv->hadjustment) : 0;
+      size = allocation.width;
+    }
+  exo_icon_view_get_line_items (icon_view, start - 1, start + size + 1, &visible_first, &visible_last);
 
-          items = items->next;
-        }
+  /* update the items that may have entered the viewport, skipping the
+   * ones updated above */
+  exo_icon_view_accessible_update_visibility (priv, visible_first, MIN (visible_last, first), &showing_first, &showing_last);
+  exo_icon_view_accessible_update_visibility (priv, MAX (visible_first, last), visible_last, &showing_first, &showing_last);
+
+  if (showing_first < showing_last)
+    {
+      priv->showing_first = showing_first;
+      priv->showing_last = showing_last;
+    }
+  else
+    {
+      priv->showing_first = priv->showing_last = 0;
     }
 }
 
@@ -1285,7 +1322,7 @@ exo_icon_view_accessible_adjustment_changed (GtkAdjustment *adjustment,
   obj = gtk_widget_get_accessible (GTK_WIDGET (icon_view));
   view = EXO_ICON_VIEW_ACCESSIBLE (obj);
 
-  exo_icon_view_accessible_traverse_items (view, NULL);
+  exo_icon_view_accessible_traverse_items (view, 0);
 }
 
 static void
@@ -1397,11 +1434,7 @@ exo_icon_view_accessible_model_row_inserted (GtkTreeModel *tree_model,
                                              gpointer     user_data)
 {
   ExoIconViewAccessiblePrivate *priv;
-  ExoIconViewItemAccessibleInfo *info;
   ExoIconViewAccessible *view;
-  ExoIconViewItemAccessible *item;
-  GList *items;
-  GList *tmp_list;
   AtkObject *atk_obj;
   gint idx;
 
@@ -1410,26 +1443,11 @@ exo_icon_view_accessible_model_row_inserted (GtkTreeModel *tree_model,
   view = EXO_ICON_VIEW_ACCESSIBLE (atk_obj);
   priv = exo_icon_view_accessible_get_priv (atk_obj);
 
-  items = priv->items;
-  tmp_list = NULL;
-  while (items)
-    {
-      info = items->data;
-      item = EXO_ICON_VIEW_ITEM_ACCESSIBLE (info->item);
-      if (info->index != accessible_item_index (item))
-        {
-          if (info->index < idx)
-            g_warning ("Unexpected index value on insertion %d %d", idx, info->index);
-
-          if (tmp_list == NULL)
-            tmp_list = items;
+  /* the following item accessibles move along with their items */
+  if (idx < (gint) priv->items->len)
+    g_ptr_array_insert (priv->items, idx, NULL);
 
-          info->index = accessible_item_index (item);
-        }
-
-      items = items->next;
-    }
-  exo_icon_view_accessible_traverse_items (view, tmp_list);
+  exo_icon_view_accessible_traverse_items (view, 1);
   g_signal_emit_by_name (atk_obj, "children-changed::add",
                          idx, NULL, NULL);
   return;
@@ -1441,12 +1459,8 @@ exo_icon_view_accessible_model_row_deleted (GtkTreeModel *tree_model,
                                             gpointer     user_data)
 {
   ExoIconViewAccessiblePrivate *priv;
-  ExoIconViewItemAccessibleInfo *info;
   ExoIconViewAccessible *view;
-  ExoIconViewItemAccessible *item;
-  GList *items;
-  GList *tmp_list;
-  GList *deleted_item;
+  ExoIconViewItemAccessible *item = NULL;
   AtkObject *atk_obj;
   gint idx;
 
@@ -1455,49 +1469,28 @@ exo_icon_view_accessible_model_row_deleted (GtkTreeModel *tree_model,
   view = EXO_ICON_VIEW_ACCESSIBLE (atk_obj);
   priv = exo_icon_view_accessible_get_priv (atk_obj);
 
-  items = priv->items;
-  tmp_list = NULL;
-  deleted_item = NULL;
-  info = NULL;
-  while (items)
+  if (idx < (gint) priv->items->len)
     {
-      info = items->data;
-      item = EXO_ICON_VIEW_ITEM_ACCESSIBLE (info->item);
-      if (info->index == idx)
-        {
-          deleted_item = items;
-        }
-      if (info->index != accessible_item_index (item))
-        {
-          if (tmp_list == NULL)
-            tmp_list = items;
-
-          info->index = accessible_item_index (item);
-        }
+      item = g_ptr_array_index (priv->items, idx);
+      g_ptr_array_remove_index (priv->items, idx);
 
-      items = items->next;
+      /* the item is already gone from the icon view */
+      if (item != NULL)
+        item->item = NULL;
     }
-  exo_icon_view_accessible_traverse_items (view, tmp_list);
-  if (deleted_item)
+
+  exo_icon_view_accessible_traverse_items (view, 1);
+  if (item != NULL)
     {
-      info = deleted_item->data;
-      exo_icon_view_item_accessible_add_state (EXO_ICON_VIEW_ITEM_ACCESSIBLE (info->item), ATK_STATE_DEFUNCT, TRUE);
+      exo_icon_view_item_accessible_add_state (item, ATK_STATE_DEFUNCT, TRUE);
       g_signal_emit_by_name (atk_obj, "children-changed::remove",
                              idx, NULL, NULL);
-      priv->items = g_list_remove_link (priv->items, deleted_item);
-      g_free (info);
+      g_object_unref (item);
     }
 
   return;
 }
 
-static gint
-exo_icon_view_accessible_item_compare (ExoIconViewItemAccessibleInfo *i1,
-                                       ExoIconViewItemAccessibleInfo *i2)
-{
-  return i1->index - i2->index;
-}
-
 static void
 exo_icon_view_accessible_model_rows_reordered (GtkTreeModel *tree_model,
                                                GtkTreePath  *path,
@@ -1506,36 +1499,41 @@ exo_icon_view_accessible_model_rows_reordered (GtkTreeModel *tree_model,
                                                gpointer     user_data)
 {
   ExoIconViewAccessiblePrivate *priv;
-  ExoIconViewItemAccessibleInfo *info;
   ExoIconView *icon_view;
   ExoIconViewItemAccessible *item;
-  GList *items;
+  GPtrArray *items;
   AtkObject *atk_obj;
-  gint *order;
   gint length, i;
 
   atk_obj = gtk_widget_get_accessible (GTK_WIDGET (user_data));
   icon_view = EXO_ICON_VIEW (user_data);
   priv = exo_icon_view_accessible_get_priv (atk_obj);
 
+  if (priv->items->len == 0)
+    return;
+
   length = gtk_tree_model_iter_n_children (tree_model, NULL);
 
-  order = g_new (gint, length);
+  /* new_order[i] is the former row of the item now at row i */
+  items = g_ptr_array_sized_new (length);
+  g_ptr_array_set_size (items, length);
   for (i = 0; i < length; i++)
-    order[new_order[i]] = i;
-
-  items = priv->items;
-  while (items)
     {
-      info = items->data;
-      item = EXO_ICON_VIEW_ITEM_ACCESSIBLE (info->item);
-      info->index = order[info->index];
-      item->item = g_list_nth_data (icon_view->priv->items, info->index);
-      items = items->next;
+      if (new_order[i] >= (gint) priv->items->len)
+        continue;
+
+      item = g_ptr_array_index (priv->items, new_order[i]);
+      if (item != NULL)
+        item->item = EXO_ICON_VIEW_NTH_ITEM (icon_view, i);
+      g_ptr_array_index (items, i) = item;
     }
-  g_free (order);
-  priv->items = g_list_sort (priv->items,
-                             (GCompareFunc)exo_icon_view_accessible_item_compare);
+  g_ptr_array_free (priv->items, TRUE);
+  priv->items = items;
+
+  /* the showing items may be anywhere now */
+  priv->showing_first = 0;
+  priv->showing_last = length;
+  exo_icon_view_accessible_traverse_items (EXO_ICON_VIEW_ACCESSIBLE (atk_obj), 0);
 
   return;
 }
@@ -1576,19 +1574,58 @@ exo_icon_view_accessible_connect_model_signals (ExoIconView *icon_view)
 static void
 exo_icon_view_accessible_clear_cache (ExoIconViewAccessiblePrivate *priv)
 {
-  ExoIconViewItemAccessibleInfo *info;
-  GList *items;
+  ExoIconViewItemAccessible *item;
+  guint n;
 
-  items = priv->items;
-  while (items)
+  for (n = 0; n < priv->items->len; ++n)
     {
-      info = (ExoIconViewItemAccessibleInfo *) items->data;
-      g_object_unref (info->item);
-      g_free (items->data);
-      items = items->next;
+      item = g_ptr_array_index (priv->items, n);
+      if (item != NULL)
+        {
+          /* the item accessible may outlive the item it refers to */
+          item->item = NULL;
+          exo_icon_view_item_accessible_add_state (item, ATK_STATE_DEFUNCT, TRUE);
+          g_object_unref (item);
+        }
     }
-  g_list_free (priv->items);
-  priv->items = NULL;
+  g_ptr_array_set_size (priv->items, 0);
+  priv->showing_first = priv->showing_last = 0;
+}
+
+static gboolean
+exo_icon_view_accessible_is_connected (ExoIconView *icon_view)
+{
+  /* the accessible follows the model once it has been created */
+  return (icon_view->priv->model != NULL
+          && g_signal_handler_find (icon_view->priv->model, G_SIGNAL_MATCH_FUNC | G_SIGNAL_MATCH_DATA, 0, 0, NULL,
+                                    exo_icon_view_accessible_model_row_inserted, icon_view) != 0);
+}
+
+static gboolean
+exo_icon_view_accessible_has_item (ExoIconView *icon_view,
+                                   gint         idx)
+{
+  AtkObject *atk_obj;
+
+  if (!exo_icon_view_accessible_is_connected (icon_view))
+    return FALSE;
+
+  atk_obj = gtk_widget_get_accessible (GTK_WIDGET (icon_view));
+  return (exo_icon_view_accessible_find_child (atk_obj, idx) != NULL);
+}
+
+static void
+exo_icon_view_accessible_items_rebuilt (ExoIconView *icon_view)
+{
+  AtkObject *atk_obj;
+
+  /* nothing to do unless the accessible follows the model */
+  if (!exo_icon_view_accessible_is_connected (icon_view))
+    return;
+
+  atk_obj = gtk_widget_get_accessible (GTK_WIDGET (icon_view));
+  exo_icon_view_accessible_clear_cache (exo_icon_view_accessible_get_priv (atk_obj));
+  g_signal_emit_by_name (atk_obj, "visible-data-changed");
 }
 
 static void
@@ -1637,6 +1674,7 @@ exo_icon_view_accessible_initialize (AtkObject *accessible,
     ATK_OBJECT_CLASS (accessible_parent_class)->initialize (accessible, data);
 
   priv = g_new0 (ExoIconViewAccessiblePrivate, 1);
+  priv->items = g_ptr_array_new ();
   g_object_set_qdata (G_OBJECT (accessible),
                       accessible_private_data_quark,
                       priv);
@@ -1686,6 +1724,7 @@ exo_icon_view_accessible_finalize (GObject *object)
 
   priv = exo_icon_view_accessible_get_priv (ATK_OBJECT (object));
   exo_icon_view_accessible_clear_cache (priv);
+  g_ptr_array_free (priv->items, TRUE);
 
   g_free (priv);
 
@@ -1778,9 +1817,11 @@ exo_icon_view_accessible_ref_accessible_at_point (AtkComponent *component,
   icon_view = EXO_ICON_VIEW (widget);
   atk_component_get_extents (component, &x_pos, &y_pos, NULL, NULL, coord_type);
   item = exo_icon_view_get_item_at_coords (icon_view, x - x_pos, y - y_pos, TRUE, NULL);
-  idx = g_list_index (icon_view->priv->items, item);
   if (item)
-    return exo_icon_view_accessible_ref_child (ATK_OBJECT (component), idx);
+    {
+      idx = item->index;
+      return exo_icon_view_accessible_ref_child (ATK_OBJECT (component), idx);
+    }
 
   return NULL;
 }
@@ -1805,11 +1846,11 @@ exo_icon_view_accessible_add_selection (AtkSelection *selection,
 
   icon_view = EXO_ICON_VIEW (widget);
 
-  item = g_list_nth_data (icon_view->priv->items, i);
-
-  if (!item)
+  if (i < 0 || i >= EXO_ICON_VIEW_N_ITEMS (icon_view))
     return FALSE;
 
+  item = EXO_ICON_VIEW_NTH_ITEM (icon_view, i);
+
   exo_icon_view_select_item (icon_view, item);
 
   return TRUE;
@@ -1835,10 +1876,8 @@ static AtkObject*
 exo_icon_view_accessible_ref_selection (AtkSelection *selection,
                                         gint          i)
 {
-  GList *l;
   GtkWidget *widget;
   ExoIconView *icon_view;
-  ExoIconViewItem *item;
   gint idx;
 
   widget = gtk_accessible_get_widget (GTK_ACCESSIBLE (selection));
@@ -1847,23 +1886,11 @@ exo_icon_view_accessible_ref_selection (AtkSelection *selection,
 
   icon_view = EXO_ICON_VIEW (widget);
 
-  l = icon_view->priv->items;
-  idx = 0;
-  while (l)
-    {
-      item = l->data;
-      if (item->selected)
-        {
-          if (i == 0)
-            return atk_object_ref_accessible_child (gtk_widget_get_accessible (widget), idx);
-          else
-            i--;
-        }
-      l = l->next;
-      idx++;
-    }
+  idx = exo_icon_view_selection_nth (&icon_view->priv->selection, EXO_ICON_VIEW_N_ITEMS (icon_view), i);
+  if (idx < 0)
+    return NULL;
 
-  return NULL;
+  return atk_object_ref_accessible_child (gtk_widget_get_accessible (widget), idx);
 }
 
 static gint
@@ -1871,9 +1898,6 @@ exo_icon_view_accessible_get_selection_count (AtkSelection *selection)
 {
   GtkWidget *widget;
   ExoIconView *icon_view;
-  ExoIconViewItem *item;
-  GList *l;
-  gint count;
 
   widget = gtk_accessible_get_widget (GTK_ACCESSIBLE (selection));
   if (widget == NULL)
@@ -1881,19 +1905,7 @@ exo_icon_view_accessible_get_selection_count (AtkSelection *selection)
 
   icon_view = EXO_ICON_VIEW (widget);
 
-  l = icon_view->priv->items;
-  count = 0;
-  while (l)
-    {
-      item = l->data;
-
-      if (item->selected)
-        count++;
-
-      l = l->next;
-    }
-
-  return count;
+  return exo_icon_view_selection_count (&icon_view->priv->selection, EXO_ICON_VIEW_N_ITEMS (icon_view));
 }
 
 static gboolean
@@ -1902,7 +1914,6 @@ exo_icon_view_accessible_is_child_selected (AtkSelection *selection,
 {
   GtkWidget *widget;
   ExoIconView *icon_view;
-  ExoIconViewItem *item;
 
   widget = gtk_accessible_get_widget (GTK_ACCESSIBLE (selection));
   if (widget == NULL)
@@ -1910,11 +1921,10 @@ exo_icon_view_accessible_is_child_selected (AtkSelection *selection,
 
   icon_view = EXO_ICON_VIEW (widget);
 
-  item = g_list_nth_data (icon_view->priv->items, i);
-  if (!item)
+  if (i < 0 || i >= EXO_ICON_VIEW_N_ITEMS (icon_view))
     return FALSE;
 
-  return item->selected;
+  return exo_icon_view_selection_contains (&icon_view->priv->selection, i);
 }
 
 static gboolean
@@ -1923,33 +1933,21 @@ exo_icon_view_accessible_remove_selection (AtkSelection *selection,
 {
   GtkWidget *widget;
   ExoIconView *icon_view;
-  ExoIconViewItem *item;
-  GList *l;
-  gint count;
+  gint idx;
 
   widget = gtk_accessible_get_widget (GTK_ACCESSIBLE (selection));
   if (widget == NULL)
     return FALSE;
 
   icon_view = EXO_ICON_VIEW (widget);
-  l = icon_view->priv->items;
-  count = 0;
-  while (l)
-    {
-      item = l->data;
-      if (item->selected)
-        {
-          if (count == i)
-            {
-              exo_icon_view_unselect_item (icon_view, item);
-              return TRUE;
-            }
-          count++;
-        }
-      l = l->next;
-    }
 
-  return FALSE;
+  idx = exo_icon_view_selection_nth (&icon_view->priv->selection, EXO_ICON_VIEW_N_ITEMS (icon_view), i);
+  if (idx < 0)
+    return FALSE;
+
+  exo_icon_view_unselect_item (icon_view, EXO_ICON_VIEW_NTH_ITEM (icon_view, idx));
+
+  return TRUE;
 }
 
 static gboolean
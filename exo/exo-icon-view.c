@@ -61,6 +61,12 @@
  * (depending on the selection mode, see exo_icon_view_set_selection_mode()).
  * In addition to selection with the arrow keys, #ExoIconView supports
  * rubberband selection, which is controlled by dragging the pointer.
+ *
+ * Changing a property that affects the geometry of the items, like
+ * #ExoIconView:item-width or #ExoIconView:spacing, takes effect when the
+ * property change is notified. To change several of them with a single
+ * relayout, set them with g_object_set() or between g_object_freeze_notify()
+ * and g_object_thaw_notify().
  **/
 
 /* resurrect dead gdk apis for Gtk3
@@ -82,6 +88,13 @@
 /* the search dialog timeout (in ms) */
 #define EXO_ICON_VIEW_SEARCH_DIALOG_TIMEOUT (5000)
 
+/* the time spent searching per main loop iteration (in us) */
+#define EXO_ICON_VIEW_SEARCH_SLICE_TIME (4000)
+
+/* the number of items materialized in fixed item size mode before
+ * the items scrolled out of view are released again */
+#define EXO_ICON_VIEW_MATERIALIZE_LIMIT (1024)
+
 #define SCROLL_EDGE_SIZE 15
 
 
@@ -108,6 +121,7 @@ enum
   PROP_SINGLE_CLICK,
   PROP_SINGLE_CLICK_TIMEOUT,
   PROP_ENABLE_SEARCH,
+  PROP_FIXED_ITEM_SIZE,
   PROP_SEARCH_COLUMN,
   PROP_HADJUSTMENT,
   PROP_VADJUSTMENT,
@@ -143,9 +157,16 @@ typedef enum
 
 
 
-typedef struct _ExoIconViewCellInfo ExoIconViewCellInfo;
-typedef struct _ExoIconViewChild    ExoIconViewChild;
-typedef struct _ExoIconViewItem     ExoIconViewItem;
+typedef struct _ExoIconViewArena     ExoIconViewArena;
+typedef struct _ExoIconViewAttribute ExoIconViewAttribute;
+typedef struct _ExoIconViewCellInfo  ExoIconViewCellInfo;
+typedef struct _ExoIconViewChild     ExoIconViewChild;
+typedef struct _ExoIconViewItem      ExoIconViewItem;
+typedef struct _ExoIconViewLine      ExoIconViewLine;
+typedef struct _ExoIconViewRange     ExoIconViewRange;
+typedef struct _ExoIconViewSelection ExoIconViewSelection;
+typedef struct _ExoIconViewSizeCache ExoIconViewSizeCache;
+typedef struct _ExoIconViewTextExtents ExoIconViewTextExtents;
 
 
 
@@ -153,6 +174,28 @@ typedef struct _ExoIconViewItem     ExoIconViewItem;
 #define EXO_ICON_VIEW_CHILD(obj)       ((ExoIconViewChild *) (obj))
 #define EXO_ICON_VIEW_ITEM(obj)        ((ExoIconViewItem *) (obj))
 
+/* Number of items measured to estimate the size of all items in fixed item size mode */
+#define EXO_ICON_VIEW_FIXED_SAMPLE_SIZE (32)
+
+/* Number of item records allocated at once by the item arena */
+#define EXO_ICON_VIEW_ARENA_BLOCK_SIZE (256)
+
+/* Minimum number of text sizes remembered per text cell */
+#define EXO_ICON_VIEW_TEXT_EXTENTS_MIN (1024)
+
+/* Number of previous cell configurations whose item sizes are remembered */
+#define EXO_ICON_VIEW_SIZE_CACHES (4)
+
+/* Item array access; with a fixed item size, items are only materialized
+ * when needed and EXO_ICON_VIEW_PEEK_ITEM() returns %NULL for the others.
+ */
+#define EXO_ICON_VIEW_N_ITEMS(icon_view)      ((gint) (icon_view)->priv->items->len)
+#define EXO_ICON_VIEW_NTH_ITEM(icon_view, n)  (exo_icon_view_get_nth_item ((icon_view), (n)))
+#define EXO_ICON_VIEW_PEEK_ITEM(icon_view, n) (EXO_ICON_VIEW_ITEM (g_ptr_array_index ((icon_view)->priv->items, (n))))
+
+/* Selection state of an item */
+#define EXO_ICON_VIEW_ITEM_SELECTED(icon_view, item) (exo_icon_view_selection_contains (&(icon_view)->priv->selection, (item)->index))
+
 
 
 static void                 exo_icon_view_cell_layout_init               (GtkCellLayoutIface     *iface);
@@ -166,8 +209,12 @@ static void                 exo_icon_view_set_property                   (GObjec
                                                                           guint                   prop_id,
                                                                           const GValue           *value,
                                                                           GParamSpec             *pspec);
+static void                 exo_icon_view_dispatch_properties_changed    (GObject                *object,
+                                                                          guint                   n_pspecs,
+                                                                          GParamSpec            **pspecs);
 static void                 exo_icon_view_realize                        (GtkWidget              *widget);
 static void                 exo_icon_view_unrealize                      (GtkWidget              *widget);
+static void                 exo_icon_view_style_updated                  (GtkWidget              *widget);
 static void                 exo_icon_view_get_preferred_width            (GtkWidget              *widget,
                                                                           gint                   *minimal_width,
                                                                           gint                   *natural_width);
@@ -213,12 +260,14 @@ static gint                 exo_icon_view_layout_cols                    (ExoIco
                                                                           gint                    item_height,
                                                                           gint                   *x,
                                                                           gint                   *maximum_height,
-                                                                          gint                    max_rows);
+                                                                          gint                    max_rows,
+                                                                          gint                    first_line);
 static gint                 exo_icon_view_layout_rows                    (ExoIconView            *icon_view,
                                                                           gint                    item_width,
                                                                           gint                   *y,
                                                                           gint                   *maximum_width,
-                                                                          gint                    max_cols);
+                                                                          gint                    max_cols,
+                                                                          gint                    first_line);
 static void                 exo_icon_view_layout                         (ExoIconView            *icon_view);
 static void                 exo_icon_view_paint_item                     (ExoIconView            *icon_view,
                                                                           ExoIconViewItem        *item,
@@ -228,7 +277,16 @@ static void                 exo_icon_view_paint_item                     (ExoIco
                                                                           gboolean                draw_focus);
 static void                 exo_icon_view_queue_draw_item                (ExoIconView            *icon_view,
                                                                           ExoIconViewItem        *item);
+static void                 exo_icon_view_queue_selection_changed        (ExoIconView            *icon_view);
+static void                 exo_icon_view_flush_pending                  (ExoIconView            *icon_view);
+static void                 exo_icon_view_before_paint                   (GdkFrameClock          *frame_clock,
+                                                                          ExoIconView            *icon_view);
 static void                 exo_icon_view_queue_layout                   (ExoIconView            *icon_view);
+static void                 exo_icon_view_queue_layout_from              (ExoIconView            *icon_view,
+                                                                          gint                    first_item,
+                                                                          gint                    last_item);
+static void                 exo_icon_view_release_item_size              (ExoIconView            *icon_view,
+                                                                          const GdkRectangle     *area);
 static void                 exo_icon_view_set_cursor_item                (ExoIconView            *icon_view,
                                                                           ExoIconViewItem        *item,
                                                                           gint                    cursor_cell);
@@ -244,6 +302,35 @@ static gboolean             exo_icon_view_item_hit_test                  (ExoIco
                                                                           gint                    width,
                                                                           gint                    height);
 static gboolean             exo_icon_view_unselect_all_internal          (ExoIconView            *icon_view);
+static gboolean             exo_icon_view_selection_contains             (const ExoIconViewSelection *selection,
+                                                                          gint                    item_index);
+static void                 exo_icon_view_selection_reset                (ExoIconViewSelection   *selection,
+                                                                          gboolean                all_selected);
+static void                 exo_icon_view_selection_copy                 (ExoIconViewSelection   *dest,
+                                                                          const ExoIconViewSelection *source);
+static gboolean             exo_icon_view_selection_next_range           (const ExoIconViewSelection *selection,
+                                                                          gint                    n_items,
+                                                                          gint                    from,
+                                                                          gint                   *start_return,
+                                                                          gint                   *end_return);
+static gint                 exo_icon_view_selection_count                (const ExoIconViewSelection *selection,
+                                                                          gint                    n_items);
+static gint                 exo_icon_view_selection_nth                  (const ExoIconViewSelection *selection,
+                                                                          gint                    n_items,
+                                                                          gint                    nth);
+static void                 exo_icon_view_set_item_selected              (ExoIconView            *icon_view,
+                                                                          ExoIconViewItem        *item,
+                                                                          gboolean                selected);
+static guint                exo_icon_view_text_extents_hash              (gconstpointer           key);
+static gboolean             exo_icon_view_text_extents_equal             (gconstpointer           a,
+                                                                          gconstpointer           b);
+static void                 exo_icon_view_text_extents_free              (gpointer                data);
+static gboolean             exo_icon_view_lookup_text_extents            (ExoIconView            *icon_view,
+                                                                          ExoIconViewCellInfo    *info,
+                                                                          GdkRectangle           *box);
+static void                 exo_icon_view_store_text_extents             (ExoIconView            *icon_view,
+                                                                          ExoIconViewCellInfo    *info,
+                                                                          const GdkRectangle     *box);
 static void                 exo_icon_view_calculate_item_size            (ExoIconView            *icon_view,
                                                                           ExoIconViewItem        *item);
 static void                 exo_icon_view_calculate_item_size2           (ExoIconView            *icon_view,
@@ -252,6 +339,26 @@ static void                 exo_icon_view_calculate_item_size2           (ExoIco
                                                                           gint                   *max_height);
 static void                 exo_icon_view_update_rubberband              (gpointer                data);
 static void                 exo_icon_view_invalidate_sizes               (ExoIconView            *icon_view);
+static gchar               *exo_icon_view_get_size_key                   (ExoIconView            *icon_view);
+static void                 exo_icon_view_size_cache_free                (gpointer                data);
+static void                 exo_icon_view_drop_size_caches               (ExoIconView            *icon_view);
+static void                 exo_icon_view_save_sizes                     (ExoIconView            *icon_view);
+static void                 exo_icon_view_restore_item_area              (ExoIconView            *icon_view,
+                                                                          ExoIconViewItem        *item,
+                                                                          const gboolean         *visible);
+static void                 exo_icon_view_invalidate_geometry            (ExoIconView            *icon_view);
+static void                 exo_icon_view_size_caches_insert             (ExoIconView            *icon_view,
+                                                                          gint                    index);
+static void                 exo_icon_view_size_caches_delete             (ExoIconView            *icon_view,
+                                                                          gint                    index);
+static void                 exo_icon_view_size_caches_forget             (ExoIconView            *icon_view,
+                                                                          gint                    index);
+static void                 exo_icon_view_size_caches_reorder            (ExoIconView            *icon_view,
+                                                                          gint                    length,
+                                                                          const gint             *new_order);
+static void                 exo_icon_view_sample_item_size               (ExoIconView            *icon_view);
+static void                 exo_icon_view_refine_item                    (ExoIconView            *icon_view,
+                                                                          ExoIconViewItem        *item);
 static void                 exo_icon_view_add_move_binding               (GtkBindingSet          *binding_set,
                                                                           guint                   keyval,
                                                                           guint                   modmask,
@@ -277,6 +384,46 @@ static void                 exo_icon_view_unselect_item                  (ExoIco
 static gboolean             exo_icon_view_select_all_between             (ExoIconView            *icon_view,
                                                                           ExoIconViewItem        *anchor,
                                                                           ExoIconViewItem        *cursor);
+static gint                 exo_icon_view_find_line                      (const ExoIconView      *icon_view,
+                                                                          gint                    item_index);
+static gint                 exo_icon_view_get_item_line                  (const ExoIconView      *icon_view,
+                                                                          const ExoIconViewItem  *item);
+static ExoIconViewItem     *exo_icon_view_get_item_on_line               (ExoIconView            *icon_view,
+                                                                          gint                    line,
+                                                                          gint                    position);
+static void                 exo_icon_view_get_line_items                 (const ExoIconView      *icon_view,
+                                                                          gint                    start,
+                                                                          gint                    end,
+                                                                          gint                   *first_item,
+                                                                          gint                   *last_item);
+static ExoIconViewItem *    exo_icon_view_get_item_for_path              (const ExoIconView      *icon_view,
+                                                                          GtkTreePath            *path);
+static void                 exo_icon_view_update_item_indices            (ExoIconView            *icon_view,
+                                                                          gint                    first);
+static ExoIconViewItem *    exo_icon_view_get_nth_item                   (const ExoIconView      *icon_view,
+                                                                          gint                    item_index);
+static ExoIconViewItem *    exo_icon_view_materialize_item               (ExoIconView            *icon_view,
+                                                                          gint                    item_index);
+static void                 exo_icon_view_release_items                  (ExoIconView            *icon_view);
+static ExoIconViewItem *    exo_icon_view_item_new                       (ExoIconView            *icon_view);
+static void                 exo_icon_view_item_free                      (ExoIconView            *icon_view,
+                                                                          ExoIconViewItem        *item);
+static void                 exo_icon_view_item_free_geometry             (ExoIconViewArena       *arena,
+                                                                          ExoIconViewItem        *item);
+static void                 exo_icon_view_item_set_n_cells               (ExoIconView            *icon_view,
+                                                                          ExoIconViewItem        *item);
+static void                 exo_icon_view_build_items                    (ExoIconView            *icon_view);
+static void                 exo_icon_view_drop_items                     (ExoIconView            *icon_view);
+static void                 exo_icon_view_forget_items                   (ExoIconView            *icon_view);
+static void                 exo_icon_view_reset_items                    (ExoIconView            *icon_view);
+static void                 exo_icon_view_freeze_items                   (ExoIconView            *icon_view,
+                                                                          gint                    changed_row,
+                                                                          gint                    delta,
+                                                                          const gint             *new_order);
+static void                 exo_icon_view_snapshot_items                 (ExoIconView            *icon_view,
+                                                                          gint                    changed_row,
+                                                                          gint                    delta,
+                                                                          const gint             *new_order);
 static ExoIconViewItem *    exo_icon_view_get_item_at_coords             (const ExoIconView      *icon_view,
                                                                           gint                    x,
                                                                           gint                    y,
@@ -290,6 +437,9 @@ static ExoIconViewCellInfo *exo_icon_view_get_cell_info                  (ExoIco
                                                                           GtkCellRenderer        *renderer);
 static void                 exo_icon_view_set_cell_data                  (const ExoIconView      *icon_view,
                                                                           ExoIconViewItem        *item);
+static void                 exo_icon_view_text_cell_notify               (GtkCellRenderer        *cell,
+                                                                          GParamSpec             *pspec,
+                                                                          ExoIconView            *icon_view);
 static void                 exo_icon_view_cell_layout_pack_start         (GtkCellLayout          *layout,
                                                                           GtkCellRenderer        *renderer,
                                                                           gboolean                expand);
@@ -419,6 +569,39 @@ static gboolean exo_icon_view_search_scroll_event       (GtkWidget      *widget,
                                                          ExoIconView    *icon_view);
 static gboolean exo_icon_view_search_timeout            (gpointer        user_data);
 static void     exo_icon_view_search_timeout_destroy    (gpointer        user_data);
+static gchar   *exo_icon_view_search_fold               (const gchar    *text);
+static gchar   *exo_icon_view_search_key                (GtkTreeModel   *model,
+                                                         GtkTreeIter    *iter,
+                                                         gint            column);
+static gint     exo_icon_view_search_compare_keys       (gconstpointer   a,
+                                                         gconstpointer   b,
+                                                         gpointer        user_data);
+static gint     exo_icon_view_search_compare_rows       (gconstpointer   a,
+                                                         gconstpointer   b);
+static void     exo_icon_view_search_index_build        (ExoIconView    *icon_view);
+static void     exo_icon_view_search_index_drop         (ExoIconView    *icon_view);
+static guint    exo_icon_view_search_index_find         (ExoIconView    *icon_view,
+                                                         const gchar    *key,
+                                                         gint            row);
+static void     exo_icon_view_search_index_insert       (ExoIconView    *icon_view,
+                                                         GtkTreeIter    *iter,
+                                                         gint            row);
+static void     exo_icon_view_search_index_delete       (ExoIconView    *icon_view,
+                                                         gint            row);
+static void     exo_icon_view_search_index_changed      (ExoIconView    *icon_view,
+                                                         GtkTreeIter    *iter,
+                                                         gint            row);
+static void     exo_icon_view_search_index_reorder      (ExoIconView    *icon_view,
+                                                         gint            length,
+                                                         const gint     *new_order);
+static GArray  *exo_icon_view_search_index_lookup       (ExoIconView    *icon_view,
+                                                         const gchar    *text);
+static void     exo_icon_view_search_slice_start        (ExoIconView    *icon_view,
+                                                         const gchar    *text,
+                                                         gint            n);
+static void     exo_icon_view_search_slice_cancel       (ExoIconView    *icon_view);
+static gboolean exo_icon_view_search_slice              (gpointer        user_data);
+static void     exo_icon_view_search_slice_destroy      (gpointer        user_data);
 
 
 
@@ -429,11 +612,45 @@ struct _ExoIconViewCellInfo
   guint                 pack : 1;
   guint                 editing : 1;
   gint                  position;
-  GSList               *attributes;
+  GArray               *attributes;
   GtkCellLayoutDataFunc func;
   gpointer              func_data;
   GDestroyNotify        destroy;
   gboolean              is_text;
+
+  /* for text cells: the string bound to the text or markup property
+   * for the current item, and the sizes measured for such strings
+   */
+  gchar                *text;
+  gboolean              text_is_markup;
+  gint                  wrap_width;
+  GHashTable           *text_extents;
+};
+
+/* A cell renderer property bound to a model column */
+struct _ExoIconViewAttribute
+{
+  GParamSpec *pspec;
+  gint        column;
+};
+
+/* The measured size of a text cell for a given string */
+struct _ExoIconViewTextExtents
+{
+  gchar *text;
+  gint   wrap_width;
+  guint  markup : 1;
+  guint  vertical : 1;
+  gint   width;
+  gint   height;
+};
+
+/* The cell sizes of all items measured with a previous cell configuration */
+struct _ExoIconViewSizeCache
+{
+  gchar  *key;
+  gint    n_cells;
+  GArray *sizes;
 };
 
 struct _ExoIconViewChild
@@ -447,6 +664,11 @@ struct _ExoIconViewItem
 {
   GtkTreeIter iter;
 
+  /* Position of the item in the items array, which
+   * is also the index of the item's tree path.
+   */
+  gint index;
+
   /* Bounding box (a value of -1 for width indicates
    * that the item needs to be layouted first)
    */
@@ -465,8 +687,69 @@ struct _ExoIconViewItem
 
   guint row : ((sizeof (guint) / 2) * 8) - 1;
   guint col : ((sizeof (guint) / 2) * 8) - 1;
-  guint selected : 1;
-  guint selected_before_rubberbanding : 1;
+
+  /* set for items placed with the fixed item size, whose
+   * cells were not measured and aligned yet.
+   */
+  guint needs_refine : 1;
+};
+
+/* A row (in rows layout mode) or a column (in columns layout
+ * mode) of items, used to quickly find the items in an area.
+ */
+struct _ExoIconViewLine
+{
+  /* index of the first item on this line */
+  gint first;
+
+  /* the range occupied by the line along the layout
+   * direction (y for rows and x for columns), including
+   * the spacing to the next line.
+   */
+  gint start;
+  gint end;
+};
+
+/* A range of item indices, from start up to (excluding) end */
+struct _ExoIconViewRange
+{
+  gint start;
+  gint end;
+};
+
+/* Items are allocated from blocks of records, each holding an item
+ * followed by the geometry of its cells, so the items of a view are
+ * close together in memory and all of them are released at once.
+ */
+struct _ExoIconViewArena
+{
+  GSList  *blocks;
+
+  /* the records not handed out yet in the first block */
+  gchar   *next_record;
+  guint    n_unused;
+
+  /* size of a record, with room for the geometry of n_cells cells */
+  gsize    record_size;
+  gint     n_cells;
+
+  /* records of released items, linked through their first pointer */
+  gpointer free_records;
+
+  /* number of items with more cells than fit into their record */
+  guint    n_external;
+};
+
+/* The selected items as sorted list of disjoint, non-adjacent
+ * ranges, so the selection can be tested with a binary search and
+ * iterated without looking at the unselected items. If inverted is
+ * set, the ranges are the unselected items, which makes selecting
+ * all items or inverting the selection constant time.
+ */
+struct _ExoIconViewSelection
+{
+  GArray  *ranges;
+  gboolean inverted;
 };
 
 struct _ExoIconViewPrivate
@@ -484,7 +767,62 @@ struct _ExoIconViewPrivate
 
   GtkTreeModel *model;
 
-  GList *items;
+  /* array of ExoIconViewItem's, in model order */
+  GPtrArray *items;
+
+  /* storage for the items */
+  ExoIconViewArena arena;
+
+  /* the item whose attributes are currently set on the cell renderers */
+  ExoIconViewItem *cell_data_item;
+
+  /* text size lookups, and how many of them were answered from the cache */
+  guint text_extents_lookups;
+  guint text_extents_hits;
+
+  /* the cell configuration the items were measured with, and the
+   * sizes measured with other recent configurations, most recent first
+   */
+  gchar  *size_key;
+  GSList *size_caches;
+
+  /* exo_icon_view_freeze_updates() depth, and the items that were
+   * replaced because the model changed while frozen
+   */
+  gint       freeze_count;
+  GPtrArray *frozen_items;
+
+  /* the positions of the cursor and the anchor while the items are
+   * replaced, and the visible items as drawn when frozen
+   */
+  gint             frozen_cursor;
+  gint             frozen_anchor;
+  cairo_surface_t *frozen_snapshot;
+  gint             frozen_snapshot_x;
+  gint             frozen_snapshot_y;
+
+  /* array of ExoIconViewLine's, filled by the layout */
+  GArray *lines;
+
+  /* the selected items */
+  ExoIconViewSelection selection;
+
+  /* the range of items that changed since the last layout; a
+   * last item of G_MAXINT means that all items following the
+   * first one were shifted (inserted or deleted rows).
+   */
+  gint layout_dirty_first;
+  gint layout_dirty_last;
+
+  /* parameters of the last layout, used to decide whether
+   * the next layout can continue from the dirty items.
+   */
+  gint             layout_width;
+  gint             layout_height;
+  gint             layout_item_size;
+  gint             layout_line_limit;
+  gboolean         layout_size_dirty;
+  GtkTextDirection layout_direction;
 
   GtkAdjustment *hadjustment;
   GtkAdjustment *vadjustment;
@@ -497,6 +835,14 @@ struct _ExoIconViewPrivate
   gboolean doing_rubberband;
   gint rubberband_x_1, rubberband_y_1;
   gint rubberband_x2, rubberband_y2;
+  GdkRectangle rubberband_area;
+  ExoIconViewSelection rubberband_selection;
+
+  /* redraws and selection changes collected until the next frame */
+  GdkFrameClock *frame_clock;
+  gulong before_paint_id;
+  cairo_region_t *pending_damage;
+  gboolean selection_changed_pending;
 
   guint scroll_timeout_id;
   gint scroll_value_diff;
@@ -524,6 +870,17 @@ struct _ExoIconViewPrivate
   gint column_spacing;
   gint margin;
 
+  /* Fixed item size mode: the item and cell sizes
+   * estimated from a sample of the items.
+   */
+  guint fixed_item_size : 1;
+  guint fixed_sample_valid : 1;
+  gint  fixed_item_width;
+  gint  fixed_item_height;
+  gint *fixed_cell_width;
+  gint *fixed_cell_height;
+  gint  n_materialized;
+
   gint text_column;
   gint markup_column;
   gint pixbuf_column;
@@ -588,6 +945,25 @@ struct _ExoIconViewPrivate
   GtkWidget                    *search_entry;
   GtkWidget                    *search_window;
 
+  /* the casefolded search column of every row (built when searching with
+   * the default equal function and kept while the search dialog is shown),
+   * the rows with a key sorted by it, and the rows matching the last
+   * searched key in model order
+   */
+  GPtrArray                    *search_keys;
+  GArray                       *search_sorted;
+  GArray                       *search_matches;
+  gchar                        *search_matches_key;
+
+  /* the search for the n-th match of a custom equal function, which
+   * compares the rows in slices from an idle source
+   */
+  gchar                        *search_slice_text;
+  gint                          search_slice_n;
+  gint                          search_slice_count;
+  gint                          search_slice_row;
+  guint                         search_slice_id;
+
   /* ExoIconViewFlags */
   guint flags;
 };
@@ -672,10 +1048,12 @@ exo_icon_view_class_init (ExoIconViewClass *klass)
   gobject_class->finalize = exo_icon_view_finalize;
   gobject_class->set_property = exo_icon_view_set_property;
   gobject_class->get_property = exo_icon_view_get_property;
+  gobject_class->dispatch_properties_changed = exo_icon_view_dispatch_properties_changed;
 
   gtkwidget_class = GTK_WIDGET_CLASS (klass);
   gtkwidget_class->realize = exo_icon_view_realize;
   gtkwidget_class->unrealize = exo_icon_view_unrealize;
+  gtkwidget_class->style_updated = exo_icon_view_style_updated;
   gtkwidget_class->get_preferred_width = exo_icon_view_get_preferred_width;
   gtkwidget_class->get_preferred_height = exo_icon_view_get_preferred_height;
   gtkwidget_class->size_allocate = exo_icon_view_size_allocate;
@@ -758,6 +1136,24 @@ exo_icon_view_class_init (ExoIconViewClass *klass)
                                                          TRUE,
                                                          EXO_PARAM_READWRITE));
 
+  /**
+   * ExoIconView:fixed-item-size:
+   *
+   * Setting the ::fixed-item-size property to %TRUE speeds up the
+   * #ExoIconView by assuming that all items have the same size. Only a
+   * sample of the items is measured to determine the item size, the
+   * other items are measured when they become visible.
+   *
+   * Since: 4.16
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_FIXED_ITEM_SIZE,
+                                   g_param_spec_boolean ("fixed-item-size",
+                                                         _("Fixed Item Size"),
+                                                         _("Speeds up the view by assuming that all items have the same size"),
+                                                         FALSE,
+                                                         EXO_PARAM_READWRITE));
+
 
   /**
    * ExoIconView:item-width:
@@ -1053,6 +1449,16 @@ exo_icon_view_class_init (ExoIconViewClass *klass)
    *
    * The ::selection-changed signal is emitted when the selection
    * (i.e. the set of selected items) changes.
+   *
+   * Once @icon_view is realized, the signal is emitted at most once per
+   * frame, before the frame is painted, for all changes made since the
+   * previous emission, including those made with exo_icon_view_select_path(),
+   * exo_icon_view_select_all() and similar functions. It is therefore not
+   * emitted from within these functions, unless @icon_view is not realized.
+   * While the updates of @icon_view are frozen and rows are inserted,
+   * deleted or reordered, the signal is held back until
+   * exo_icon_view_thaw_updates(). Changes still pending when @icon_view is
+   * unrealized are not reported.
    **/
   icon_view_signals[SELECTION_CHANGED] =
     g_signal_new (I_("selection-changed"),
@@ -1274,6 +1680,13 @@ exo_icon_view_init (ExoIconView *icon_view)
 
   icon_view->priv = exo_icon_view_get_instance_private (icon_view);
 
+  icon_view->priv->items = g_ptr_array_new ();
+  icon_view->priv->lines = g_array_new (FALSE, FALSE, sizeof (ExoIconViewLine));
+  icon_view->priv->selection.ranges = g_array_new (FALSE, FALSE, sizeof (ExoIconViewRange));
+  icon_view->priv->rubberband_selection.ranges = g_array_new (FALSE, FALSE, sizeof (ExoIconViewRange));
+  icon_view->priv->layout_dirty_first = 0;
+  icon_view->priv->layout_dirty_last = G_MAXINT;
+
   icon_view->priv->selection_mode = GTK_SELECTION_SINGLE;
   icon_view->priv->pressed_button = -1;
   icon_view->priv->press_start_x = -1;
@@ -1318,6 +1731,9 @@ exo_icon_view_dispose (GObject *object)
   if (G_UNLIKELY (icon_view->priv->search_timeout_id != 0))
     g_source_remove (icon_view->priv->search_timeout_id);
 
+  /* cancel any running search */
+  exo_icon_view_search_slice_cancel (icon_view);
+
   /* destroy the interactive search dialog */
   if (G_UNLIKELY (icon_view->priv->search_window != NULL))
     {
@@ -1363,6 +1779,13 @@ exo_icon_view_finalize (GObject *object)
   /* drop the cell renderers */
   exo_icon_view_cell_layout_clear (GTK_CELL_LAYOUT (icon_view));
 
+  /* release the item array (the items were freed with the model) */
+  g_ptr_array_free (icon_view->priv->items, TRUE);
+  g_array_free (icon_view->priv->lines, TRUE);
+  g_array_free (icon_view->priv->selection.ranges, TRUE);
+  g_array_free (icon_view->priv->rubberband_selection.ranges, TRUE);
+  g_free (icon_view->priv->fixed_cell_width);
+
   /* be sure to cancel the single click timeout */
   if (G_UNLIKELY (icon_view->priv->single_click_timeout_id != 0))
     g_source_remove (icon_view->priv->single_click_timeout_id);
@@ -1397,6 +1820,10 @@ exo_icon_view_get_property (GObject      *object,
       g_value_set_boolean (value, priv->enable_search);
       break;
 
+    case PROP_FIXED_ITEM_SIZE:
+      g_value_set_boolean (value, priv->fixed_item_size);
+      break;
+
     case PROP_ITEM_WIDTH:
       g_value_set_int (value, priv->item_width);
       break;
@@ -1507,6 +1934,10 @@ exo_icon_view_set_property (GObject      *object,
       exo_icon_view_set_enable_search (icon_view, g_value_get_boolean (value));
       break;
 
+    case PROP_FIXED_ITEM_SIZE:
+      exo_icon_view_set_fixed_item_size (icon_view, g_value_get_boolean (value));
+      break;
+
     case PROP_ITEM_WIDTH:
       exo_icon_view_set_item_width (icon_view, g_value_get_int (value));
       break;
@@ -1597,6 +2028,47 @@ exo_icon_view_set_property (GObject      *object,
 
 
 
+static void
+exo_icon_view_dispatch_properties_changed (GObject     *object,
+                                           guint        n_pspecs,
+                                           GParamSpec **pspecs)
+{
+  gboolean geometry = FALSE;
+  guint    n;
+
+  /* the geometry setters leave the invalidation to the notification, so
+   * properties changed with frozen notifications are applied at once
+   */
+  for (n = 0; n < n_pspecs; ++n)
+    {
+      if (pspecs[n]->owner_type != EXO_TYPE_ICON_VIEW)
+        continue;
+
+      switch (pspecs[n]->param_id)
+        {
+        case PROP_LAYOUT_MODE:
+        case PROP_ORIENTATION:
+        case PROP_ITEM_WIDTH:
+        case PROP_SPACING:
+        case PROP_ROW_SPACING:
+        case PROP_COLUMN_SPACING:
+        case PROP_MARGIN:
+          geometry = TRUE;
+          break;
+
+        default:
+          break;
+        }
+    }
+
+  if (G_UNLIKELY (geometry))
+    exo_icon_view_invalidate_geometry (EXO_ICON_VIEW (object));
+
+  (*G_OBJECT_CLASS (exo_icon_view_parent_class)->dispatch_properties_changed) (object, n_pspecs, pspecs);
+}
+
+
+
 static void
 exo_icon_view_realize (GtkWidget *widget)
 {
@@ -1642,6 +2114,10 @@ exo_icon_view_realize (GtkWidget *widget)
 
   /* map the icons window */
   gdk_window_show (priv->bin_window);
+
+  /* flush redraws and selection changes once per frame */
+  priv->frame_clock = g_object_ref (gtk_widget_get_frame_clock (widget));
+  priv->before_paint_id = g_signal_connect (G_OBJECT (priv->frame_clock), "before-paint", G_CALLBACK (exo_icon_view_before_paint), widget);
 }
 
 static void
@@ -1649,6 +2125,29 @@ exo_icon_view_unrealize (GtkWidget *widget)
 {
   ExoIconViewPrivate *priv = EXO_ICON_VIEW (widget)->priv;
 
+  /* drop what is still pending for the next frame, the icons window
+   * goes away, and the view is usually being destroyed, so the
+   * handlers must not run anymore (a selection change held back
+   * while frozen is still reported on thaw)
+   */
+  if (priv->pending_damage != NULL)
+    {
+      cairo_region_destroy (priv->pending_damage);
+      priv->pending_damage = NULL;
+    }
+  if (priv->frozen_items == NULL)
+    priv->selection_changed_pending = FALSE;
+  g_signal_handler_disconnect (G_OBJECT (priv->frame_clock), priv->before_paint_id);
+  g_object_unref (G_OBJECT (priv->frame_clock));
+  priv->frame_clock = NULL;
+
+  /* the snapshot belongs to the icons window */
+  if (G_UNLIKELY (priv->frozen_snapshot != NULL))
+    {
+      cairo_surface_destroy (priv->frozen_snapshot);
+      priv->frozen_snapshot = NULL;
+    }
+
   /* drop the icons window */
   gdk_window_set_user_data (priv->bin_window, NULL);
   gdk_window_destroy (priv->bin_window);
@@ -1659,6 +2158,27 @@ exo_icon_view_unrealize (GtkWidget *widget)
     (*GTK_WIDGET_CLASS (exo_icon_view_parent_class)->unrealize) (widget);
 }
 
+
+
+static void
+exo_icon_view_style_updated (GtkWidget *widget)
+{
+  ExoIconViewCellInfo *info;
+  ExoIconView         *icon_view = EXO_ICON_VIEW (widget);
+  GList               *lp;
+
+  /* the font may have changed, so forget the measured text sizes */
+  for (lp = icon_view->priv->cell_list; lp != NULL; lp = lp->next)
+    {
+      info = EXO_ICON_VIEW_CELL_INFO (lp->data);
+      if (info->text_extents != NULL)
+        g_hash_table_remove_all (info->text_extents);
+    }
+  exo_icon_view_drop_size_caches (icon_view);
+
+  (*GTK_WIDGET_CLASS (exo_icon_view_parent_class)->style_updated) (widget);
+}
+
 static void
 exo_icon_view_get_preferred_width (GtkWidget *widget,
                                    gint      *minimal_width,
@@ -1722,9 +2242,14 @@ exo_icon_view_allocate_children (ExoIconView *icon_view)
 
       /* totally ignore our child's requisition */
       if (child->cell < 0)
-        allocation = child->item->area;
+        {
+          allocation = child->item->area;
+        }
       else
-        allocation = child->item->box[child->cell];
+        {
+          exo_icon_view_refine_item (icon_view, child->item);
+          allocation = child->item->box[child->cell];
+        }
 
       /* increase the item area by focus width/padding */
       gtk_widget_style_get (GTK_WIDGET (icon_view), "focus-line-width", &focus_line_width, "focus-padding", &focus_padding, NULL);
@@ -1799,8 +2324,10 @@ exo_icon_view_draw (GtkWidget *widget,
   GdkRectangle            rect;
   GdkRectangle            clip;
   GdkRectangle            paint_area;
-  const GList            *lp;
   gint                    dest_index = -1;
+  gint                    first_item;
+  gint                    last_item;
+  gint                    n;
   GtkStyleContext        *context;
 
   /* verify that the expose happened on the icon window */
@@ -1831,6 +2358,19 @@ exo_icon_view_draw (GtkWidget *widget,
   /* retrieve the clipping rectangle again, with the transformed coordinates */
   gdk_cairo_get_clip_rectangle (cr, &clip);
 
+  /* the items do not match the model until thawed, so repeat what was
+   * visible when the view was frozen
+   */
+  if (G_UNLIKELY (priv->frozen_items != NULL))
+    {
+      if (priv->frozen_snapshot != NULL)
+        {
+          cairo_set_source_surface (cr, priv->frozen_snapshot, priv->frozen_snapshot_x, priv->frozen_snapshot_y);
+          cairo_paint (cr);
+        }
+      return FALSE;
+    }
+
   /* scroll to the previously remembered path (if any) */
   if (G_UNLIKELY (priv->scroll_to_path != NULL))
     {
@@ -1861,10 +2401,21 @@ exo_icon_view_draw (GtkWidget *widget,
       gtk_tree_path_free (path);
     }
 
+  /* determine the lines that are affected by the expose event */
+  if (G_LIKELY (priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
+    exo_icon_view_get_line_items (icon_view, clip.y, clip.y + clip.height, &first_item, &last_item);
+  else
+    exo_icon_view_get_line_items (icon_view, clip.x, clip.x + clip.width, &first_item, &last_item);
+
+  /* the items share the cell style, so the style context only needs
+   * to look up the CSS again when the state changes between items */
+  gtk_style_context_save (context);
+  gtk_style_context_add_class (context, GTK_STYLE_CLASS_CELL);
+
   /* paint all items that are affected by the expose event */
-  for (lp = priv->items; lp != NULL; lp = lp->next)
+  for (n = first_item; n < last_item; ++n)
     {
-      item = EXO_ICON_VIEW_ITEM (lp->data);
+      item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
 
       /* FIXME: padding? */
       paint_area.x      = item->area.x;
@@ -1878,13 +2429,12 @@ exo_icon_view_draw (GtkWidget *widget,
 
       /* paint the item */
       exo_icon_view_paint_item (icon_view, item, cr, item->area.x, item->area.y, TRUE);
-      if (G_UNLIKELY (dest_index >= 0 && dest_item == NULL))
-        {
-          if (dest_index == g_list_index (priv->items, item))
-            dest_item = item;
-        }
+      if (G_UNLIKELY (dest_index == item->index))
+        dest_item = item;
     }
 
+  gtk_style_context_restore (context);
+
   /* draw the drag indicator */
   if (G_UNLIKELY (dest_item != NULL))
     {
@@ -1959,6 +2509,12 @@ exo_icon_view_draw (GtkWidget *widget,
       cairo_restore (cr);
     }
 
+  /* release the items materialized for earlier exposes once there are
+   * too many of them, the rubberband selection may still need them */
+  if (G_UNLIKELY (priv->fixed_item_size && !priv->doing_rubberband
+                  && priv->n_materialized > MAX (EXO_ICON_VIEW_MATERIALIZE_LIMIT, 4 * (last_item - first_item))))
+    exo_icon_view_release_items (icon_view);
+
   /* let the GtkContainer forward the draw event to all children */
   GTK_WIDGET_CLASS (exo_icon_view_parent_class)->draw (widget, cr);
 
@@ -2162,7 +2718,7 @@ exo_icon_view_item_activate_cell (ExoIconView         *icon_view,
     {
       exo_icon_view_get_cell_area (icon_view, item, info, &cell_area);
 
-      path = gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1);
+      path = gtk_tree_path_new_from_indices (item->index, -1);
       path_string = gtk_tree_path_to_string (path);
       gtk_tree_path_free (path);
 
@@ -2254,7 +2810,7 @@ exo_icon_view_start_editing (ExoIconView         *icon_view,
       exo_icon_view_get_cell_area (icon_view, item, info, &cell_area);
 
       /* determine the tree path */
-      path = gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1);
+      path = gtk_tree_path_new_from_indices (item->index, -1);
       path_string = gtk_tree_path_to_string (path);
       gtk_tree_path_free (path);
 
@@ -2394,20 +2950,20 @@ exo_icon_view_button_press_event (GtkWidget      *widget,
           else
             {
               if ((icon_view->priv->selection_mode == GTK_SELECTION_MULTIPLE ||
-                  ((icon_view->priv->selection_mode == GTK_SELECTION_SINGLE) && item->selected)) &&
+                  ((icon_view->priv->selection_mode == GTK_SELECTION_SINGLE) && EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item))) &&
                   (event->state & GDK_CONTROL_MASK))
                 {
-                  item->selected = !item->selected;
+                  exo_icon_view_set_item_selected (icon_view, item, !EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item));
                   exo_icon_view_queue_draw_item (icon_view, item);
                   dirty = TRUE;
                 }
               else
                 {
-                  if (!item->selected)
+                  if (!EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item))
                     {
                       exo_icon_view_unselect_all_internal (icon_view);
 
-                      item->selected = TRUE;
+                      exo_icon_view_set_item_selected (icon_view, item, TRUE);
                       exo_icon_view_queue_draw_item (icon_view, item);
                       dirty = TRUE;
                     }
@@ -2462,7 +3018,7 @@ exo_icon_view_button_press_event (GtkWidget      *widget,
                                                    NULL);
           if (G_LIKELY (item != NULL))
             {
-              path = gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1);
+              path = gtk_tree_path_new_from_indices (item->index, -1);
               exo_icon_view_item_activated (icon_view, path);
               gtk_tree_path_free (path);
             }
@@ -2481,7 +3037,7 @@ exo_icon_view_button_press_event (GtkWidget      *widget,
     }
 
   if (dirty)
-    g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+    exo_icon_view_queue_selection_changed (icon_view);
 
   return event->button == 1;
 }
@@ -2507,7 +3063,7 @@ exo_icon_view_button_release_event (GtkWidget      *widget,
               if (icon_view->priv->single_click)
                 {
                   /* emit an "item-activated" signal for this item */
-                  path = gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1);
+                  path = gtk_tree_path_new_from_indices (item->index, -1);
                   exo_icon_view_item_activated (icon_view, path);
                   gtk_tree_path_free (path);
                 }
@@ -2729,22 +3285,24 @@ exo_icon_view_start_rubberbanding (ExoIconView  *icon_view,
                                    gint          y)
 {
   gpointer  drag_data;
-  GList    *items;
 
   /* be sure to disable any previously active rubberband */
   exo_icon_view_stop_rubberbanding (icon_view);
 
-  for (items = icon_view->priv->items; items; items = items->next)
-    {
-      ExoIconViewItem *item = items->data;
-      item->selected_before_rubberbanding = item->selected;
-    }
+  /* remember the selection before rubberbanding */
+  exo_icon_view_selection_copy (&icon_view->priv->rubberband_selection, &icon_view->priv->selection);
 
   icon_view->priv->rubberband_x_1 = x;
   icon_view->priv->rubberband_y_1 = y;
   icon_view->priv->rubberband_x2 = x;
   icon_view->priv->rubberband_y2 = y;
 
+  /* the area that was last checked for selection changes */
+  icon_view->priv->rubberband_area.x = x;
+  icon_view->priv->rubberband_area.y = y;
+  icon_view->priv->rubberband_area.width = 0;
+  icon_view->priv->rubberband_area.height = 0;
+
   icon_view->priv->doing_rubberband = TRUE;
 
   gtk_grab_add (GTK_WIDGET (icon_view));
@@ -2796,7 +3354,10 @@ exo_icon_view_update_rubberband_selection (ExoIconView *icon_view)
   gboolean         selected;
   gboolean         changed = FALSE;
   gboolean         is_in;
-  GList           *lp;
+  GdkRectangle     area;
+  gint             first_item;
+  gint             last_item;
+  gint             n;
   gint             x, y;
   gint             width;
   gint             height;
@@ -2807,43 +3368,61 @@ exo_icon_view_update_rubberband_selection (ExoIconView *icon_view)
   width = ABS (icon_view->priv->rubberband_x_1 - icon_view->priv->rubberband_x2);
   height = ABS (icon_view->priv->rubberband_y_1 - icon_view->priv->rubberband_y2);
 
-  /* check all items */
-  for (lp = icon_view->priv->items; lp != NULL; lp = lp->next)
+  /* only items within the previous or the new area can change
+   * their state, all other items are as they were before
+   */
+  area.x = MIN (x, icon_view->priv->rubberband_area.x);
+  area.y = MIN (y, icon_view->priv->rubberband_area.y);
+  area.width = MAX (x + width, icon_view->priv->rubberband_area.x + icon_view->priv->rubberband_area.width) - area.x;
+  area.height = MAX (y + height, icon_view->priv->rubberband_area.y + icon_view->priv->rubberband_area.height) - area.y;
+
+  icon_view->priv->rubberband_area.x = x;
+  icon_view->priv->rubberband_area.y = y;
+  icon_view->priv->rubberband_area.width = width;
+  icon_view->priv->rubberband_area.height = height;
+
+  if (G_LIKELY (icon_view->priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
+    exo_icon_view_get_line_items (icon_view, area.y, area.y + area.height, &first_item, &last_item);
+  else
+    exo_icon_view_get_line_items (icon_view, area.x, area.x + area.width, &first_item, &last_item);
+
+  /* check the affected items */
+  for (n = first_item; n < last_item; ++n)
     {
-      item = EXO_ICON_VIEW_ITEM (lp->data);
+      item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
 
       is_in = exo_icon_view_item_hit_test (icon_view, item, x, y, width, height);
 
-      selected = is_in ^ item->selected_before_rubberbanding;
+      selected = is_in ^ exo_icon_view_selection_contains (&icon_view->priv->rubberband_selection, n);
 
-      if (G_UNLIKELY (item->selected != selected))
+      if (G_UNLIKELY (EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item) != selected))
         {
           /* extend */
           if (icon_view->priv->shift_pressed && !icon_view->priv->ctrl_pressed)
             {
-              if (!item->selected)
+              if (!EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item))
                 {
                   changed = TRUE;
-                  item->selected = TRUE;
+                  exo_icon_view_set_item_selected (icon_view, item, TRUE);
                 }
             }
           /* add/remove */
           else
             {
               changed = TRUE;
-              item->selected = selected;
+              exo_icon_view_set_item_selected (icon_view, item, selected);
             }
 
           if (changed)
             exo_icon_view_queue_draw_item (icon_view, item);
         }
 
-      if (item->selected)
+      if (EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item))
         icon_view->priv->cursor_item = item;
     }
 
   if (G_LIKELY (changed))
-    g_signal_emit (G_OBJECT (icon_view), icon_view_signals[SELECTION_CHANGED], 0);
+    exo_icon_view_queue_selection_changed (icon_view);
 }
 
 
@@ -2860,6 +3439,8 @@ exo_icon_view_item_hit_test (ExoIconView      *icon_view,
   GdkRectangle         box;
   ExoIconViewCellInfo *info;
 
+  exo_icon_view_refine_item (icon_view, item);
+
   for (l = icon_view->priv->cell_list; l; l = l->next)
     {
       info = l->data;
@@ -2883,22 +3464,23 @@ exo_icon_view_item_hit_test (ExoIconView      *icon_view,
 static gboolean
 exo_icon_view_unselect_all_internal (ExoIconView  *icon_view)
 {
-  ExoIconViewItem *item;
-  gboolean         dirty = FALSE;
-  GList           *lp;
+  gboolean dirty = FALSE;
+  gint     start;
+  gint     end;
+  gint     n;
 
   if (G_LIKELY (icon_view->priv->selection_mode != GTK_SELECTION_NONE))
     {
-      for (lp = icon_view->priv->items; lp != NULL; lp = lp->next)
+      /* redraw the selected items */
+      for (n = 0; exo_icon_view_selection_next_range (&icon_view->priv->selection, EXO_ICON_VIEW_N_ITEMS (icon_view), n, &start, &end); n = end)
         {
-          item = EXO_ICON_VIEW_ITEM (lp->data);
-          if (item->selected)
-            {
-              dirty = TRUE;
-              item->selected = FALSE;
-              exo_icon_view_queue_draw_item (icon_view, item);
-            }
+          for (; start < end; ++start)
+            if (EXO_ICON_VIEW_PEEK_ITEM (icon_view, start) != NULL)
+              exo_icon_view_queue_draw_item (icon_view, EXO_ICON_VIEW_PEEK_ITEM (icon_view, start));
+          dirty = TRUE;
         }
+
+      exo_icon_view_selection_reset (&icon_view->priv->selection, FALSE);
     }
 
   return dirty;
@@ -3024,7 +3606,7 @@ exo_icon_view_real_activate_cursor_item (ExoIconView *icon_view)
         }
     }
 
-  path = gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, icon_view->priv->cursor_item), -1);
+  path = gtk_tree_path_new_from_indices (icon_view->priv->cursor_item->index, -1);
   exo_icon_view_item_activated (icon_view, path);
   gtk_tree_path_free (path);
 
@@ -3056,15 +3638,16 @@ exo_icon_view_real_toggle_cursor_item (ExoIconView *icon_view)
           break;
 
         case GTK_SELECTION_SINGLE:
-          if (icon_view->priv->cursor_item->selected)
+          if (EXO_ICON_VIEW_ITEM_SELECTED (icon_view, icon_view->priv->cursor_item))
             exo_icon_view_unselect_item (icon_view, icon_view->priv->cursor_item);
           else
             exo_icon_view_select_item (icon_view, icon_view->priv->cursor_item);
           break;
 
         case GTK_SELECTION_MULTIPLE:
-          icon_view->priv->cursor_item->selected = !icon_view->priv->cursor_item->selected;
-          g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+          exo_icon_view_set_item_selected (icon_view, icon_view->priv->cursor_item,
+                                           !EXO_ICON_VIEW_ITEM_SELECTED (icon_view, icon_view->priv->cursor_item));
+          exo_icon_view_queue_selection_changed (icon_view);
           exo_icon_view_queue_draw_item (icon_view, icon_view->priv->cursor_item);
           break;
 
@@ -3091,9 +3674,9 @@ exo_icon_view_adjustment_changed (GtkAdjustment *adjustment,
 
 
 
-static GList*
+static gint
 exo_icon_view_layout_single_row (ExoIconView *icon_view,
-                                 GList       *first_item,
+                                 gint         first_item,
                                  gint         item_width,
                                  gint         row,
                                  gint        *y,
@@ -3103,12 +3686,13 @@ exo_icon_view_layout_single_row (ExoIconView *icon_view,
   ExoIconViewPrivate *priv = icon_view->priv;
   ExoIconViewItem    *item;
   gboolean            rtl;
-  GList              *last_item;
-  GList              *items = first_item;
+  gint                last_item;
+  gint                n;
   gint               *max_width;
   gint               *max_height;
   gint                focus_width;
   gint                current_width;
+  gint                width;
   gint                colspan;
   gint                col = 0;
   gint                x;
@@ -3133,18 +3717,29 @@ exo_icon_view_layout_single_row (ExoIconView *icon_view,
   x = priv->margin + focus_width;
   current_width = 2 * (priv->margin + focus_width);
 
-  for (items = first_item; items != NULL; items = items->next)
+  for (n = first_item; n < EXO_ICON_VIEW_N_ITEMS (icon_view); ++n)
     {
-      item = EXO_ICON_VIEW_ITEM (items->data);
-
-      exo_icon_view_calculate_item_size (icon_view, item);
-      colspan = 1 + (item->area.width - 1) / (item_width + priv->column_spacing);
+      if (G_UNLIKELY (priv->fixed_item_size))
+        {
+          /* the cells are measured once the item becomes visible, and items
+           * that were not materialized yet take their place from the lines.
+           */
+          item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, n);
+          width = item_width;
+          colspan = 1;
+        }
+      else
+        {
+          item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
+          exo_icon_view_calculate_item_size (icon_view, item);
+          colspan = 1 + (item->area.width - 1) / (item_width + priv->column_spacing);
 
-      item->area.width = colspan * item_width + (colspan - 1) * priv->column_spacing;
+          width = colspan * item_width + (colspan - 1) * priv->column_spacing;
+        }
 
-      current_width += item->area.width + priv->column_spacing + 2 * focus_width;
+      current_width += width + priv->column_spacing + 2 * focus_width;
 
-      if (G_LIKELY (items != first_item))
+      if (G_LIKELY (n != first_item))
         {
           if ((priv->columns <= 0 && current_width > allocation.width) ||
               (priv->columns > 0 && col >= priv->columns) ||
@@ -3152,12 +3747,24 @@ exo_icon_view_layout_single_row (ExoIconView *icon_view,
             break;
         }
 
-      item->area.y = *y + focus_width;
-      item->area.x = rtl ? allocation.width - item->area.width - x : x;
+      if (G_LIKELY (item != NULL))
+        {
+          if (G_UNLIKELY (priv->fixed_item_size))
+            {
+              item->area.height = priv->fixed_item_height;
+              item->needs_refine = TRUE;
+            }
+
+          item->area.width = width;
+          item->area.y = *y + focus_width;
+          item->area.x = rtl ? allocation.width - width - x : x;
+          item->row = row;
+          item->col = col;
+        }
 
       x = current_width - (priv->margin + focus_width);
 
-      for (i = 0; i < priv->n_cells; i++)
+      for (i = 0; i < priv->n_cells && !priv->fixed_item_size; i++)
         {
           max_width[i] = MAX (max_width[i], item->box[i].width);
           max_height[i] = MAX (max_height[i], item->box[i].height);
@@ -3166,24 +3773,30 @@ exo_icon_view_layout_single_row (ExoIconView *icon_view,
       if (current_width > *maximum_width)
         *maximum_width = current_width;
 
-      item->row = row;
-      item->col = col;
-
       col += colspan;
     }
 
-  last_item = items;
+  last_item = n;
+
+  /* all items of the row have the same height with a fixed item size */
+  if (G_UNLIKELY (priv->fixed_item_size))
+    *y += 2 * focus_width + priv->fixed_item_height + priv->row_spacing;
 
   /* Now go through the row again and align the icons */
-  for (items = first_item; items != last_item; items = items->next)
+  for (n = first_item; n < last_item; ++n)
     {
-      item = EXO_ICON_VIEW_ITEM (items->data);
+      item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, n);
+      if (G_UNLIKELY (item == NULL))
+        continue;
 
-      exo_icon_view_calculate_item_size2 (icon_view, item, max_width, max_height);
+      if (G_LIKELY (!priv->fixed_item_size))
+        {
+          exo_icon_view_calculate_item_size2 (icon_view, item, max_width, max_height);
 
-      /* We may want to readjust the new y coordinate. */
-      if (item->area.y + item->area.height + focus_width + priv->row_spacing > *y)
-        *y = item->area.y + item->area.height + focus_width + priv->row_spacing;
+          /* We may want to readjust the new y coordinate. */
+          if (item->area.y + item->area.height + focus_width + priv->row_spacing > *y)
+            *y = item->area.y + item->area.height + focus_width + priv->row_spacing;
+        }
 
       if (G_UNLIKELY (rtl))
         item->col = col - 1 - item->col;
@@ -3194,9 +3807,9 @@ exo_icon_view_layout_single_row (ExoIconView *icon_view,
 
 
 
-static GList*
+static gint
 exo_icon_view_layout_single_col (ExoIconView *icon_view,
-                                 GList       *first_item,
+                                 gint         first_item,
                                  gint         item_height,
                                  gint         col,
                                  gint        *x,
@@ -3205,12 +3818,13 @@ exo_icon_view_layout_single_col (ExoIconView *icon_view,
 {
   ExoIconViewPrivate *priv = icon_view->priv;
   ExoIconViewItem    *item;
-  GList              *items = first_item;
-  GList              *last_item;
+  gint                last_item;
+  gint                n;
   gint               *max_width;
   gint               *max_height;
   gint                focus_width;
   gint                current_height;
+  gint                height;
   gint                rowspan;
   gint                row = 0;
   gint                y;
@@ -3233,31 +3847,54 @@ exo_icon_view_layout_single_col (ExoIconView *icon_view,
   y = priv->margin + focus_width;
   current_height = 2 * (priv->margin + focus_width);
 
-  for (items = first_item; items != NULL; items = items->next)
+  for (n = first_item; n < EXO_ICON_VIEW_N_ITEMS (icon_view); ++n)
     {
-      item = EXO_ICON_VIEW_ITEM (items->data);
-
-      exo_icon_view_calculate_item_size (icon_view, item);
+      if (G_UNLIKELY (priv->fixed_item_size))
+        {
+          /* the cells are measured once the item becomes visible, and items
+           * that were not materialized yet take their place from the lines.
+           */
+          item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, n);
+          height = item_height;
+          rowspan = 1;
+        }
+      else
+        {
+          item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
+          exo_icon_view_calculate_item_size (icon_view, item);
 
-      rowspan = 1 + (item->area.height - 1) / (item_height + priv->row_spacing);
+          rowspan = 1 + (item->area.height - 1) / (item_height + priv->row_spacing);
 
-      item->area.height = rowspan * item_height + (rowspan - 1) * priv->row_spacing;
+          height = rowspan * item_height + (rowspan - 1) * priv->row_spacing;
+        }
 
-      current_height += item->area.height + priv->row_spacing + 2 * focus_width;
+      current_height += height + priv->row_spacing + 2 * focus_width;
 
-      if (G_LIKELY (items != first_item))
+      if (G_LIKELY (n != first_item))
         {
           if (current_height >= allocation.height ||
              (max_rows > 0 && row >= max_rows))
             break;
         }
 
-      item->area.y = y + focus_width;
-      item->area.x = *x;
+      if (G_LIKELY (item != NULL))
+        {
+          if (G_UNLIKELY (priv->fixed_item_size))
+            {
+              item->area.width = priv->fixed_item_width;
+              item->needs_refine = TRUE;
+            }
+
+          item->area.height = height;
+          item->area.y = y + focus_width;
+          item->area.x = *x;
+          item->row = row;
+          item->col = col;
+        }
 
       y = current_height - (priv->margin + focus_width);
 
-      for (i = 0; i < priv->n_cells; i++)
+      for (i = 0; i < priv->n_cells && !priv->fixed_item_size; i++)
         {
           max_width[i] = MAX (max_width[i], item->box[i].width);
           max_height[i] = MAX (max_height[i], item->box[i].height);
@@ -3266,18 +3903,22 @@ exo_icon_view_layout_single_col (ExoIconView *icon_view,
       if (current_height > *maximum_height)
         *maximum_height = current_height;
 
-      item->row = row;
-      item->col = col;
-
       row += rowspan;
     }
 
-  last_item = items;
+  last_item = n;
+
+  /* all items of the column have the same width with a fixed item size */
+  if (G_UNLIKELY (priv->fixed_item_size))
+    {
+      *x += priv->fixed_item_width + focus_width + priv->column_spacing;
+      return last_item;
+    }
 
   /* Now go through the column again and align the icons */
-  for (items = first_item; items != last_item; items = items->next)
+  for (n = first_item; n < last_item; ++n)
     {
-      item = EXO_ICON_VIEW_ITEM (items->data);
+      item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
 
       exo_icon_view_calculate_item_size2 (icon_view, item, max_width, max_height);
 
@@ -3315,34 +3956,80 @@ exo_icon_view_layout_cols (ExoIconView *icon_view,
                            gint         item_height,
                            gint        *x,
                            gint        *maximum_height,
-                           gint         max_rows)
+                           gint         max_rows,
+                           gint         first_line)
 {
-  GList *icons = icon_view->priv->items;
-  GList *items;
-  gint   col = 0;
-  gint   rows = 0;
+  ExoIconViewPrivate *priv = icon_view->priv;
+  ExoIconViewLine     line;
+  ExoIconViewLine    *old;
+  gint                n_lines = priv->lines->len;
+  gint                icons = 0;
+  gint                col = first_line;
+  gint                rows = priv->rows;
 
-  *x = icon_view->priv->margin;
+  /* check if all columns are still valid */
+  if (G_UNLIKELY (n_lines > 0 && first_line >= n_lines))
+    {
+      *x = g_array_index (priv->lines, ExoIconViewLine, n_lines - 1).end + priv->margin;
+      return rows;
+    }
+
+  /* continue with the first column that needs to be layouted */
+  if (G_LIKELY (first_line > 0))
+    {
+      old = &g_array_index (priv->lines, ExoIconViewLine, first_line);
+      icons = old->first;
+      *x = old->start;
+    }
+  else
+    {
+      *x = priv->margin;
+    }
 
   do
     {
+      line.first = icons;
+      line.start = *x;
+
       icons = exo_icon_view_layout_single_col (icon_view, icons,
                                                item_height, col,
                                                x, maximum_height, max_rows);
 
+      line.end = *x;
+
       /* count the number of rows in the first column */
       if (G_UNLIKELY (col == 0))
+        rows = icons;
+
+      /* if the column was layouted like before and no dirty items follow,
+       * the remaining columns are unaffected and we can stop here.
+       */
+      if (icons > priv->layout_dirty_last && col + 1 < n_lines)
         {
-          for (items = icon_view->priv->items, rows = 0; items != icons; items = items->next, ++rows)
-            ;
+          old = &g_array_index (priv->lines, ExoIconViewLine, col);
+          if (old->first == line.first && old->start == line.start
+              && old->end == line.end && old[1].first == icons)
+            {
+              *x = g_array_index (priv->lines, ExoIconViewLine, n_lines - 1).end + priv->margin;
+              return rows;
+            }
         }
 
+      /* update the line index */
+      if (col < (gint) priv->lines->len)
+        g_array_index (priv->lines, ExoIconViewLine, col) = line;
+      else
+        g_array_append_val (priv->lines, line);
+
       col++;
     }
-  while (icons != NULL);
+  while (icons < EXO_ICON_VIEW_N_ITEMS (icon_view));
 
-  *x += icon_view->priv->margin;
-  icon_view->priv->cols = col;
+  /* drop the columns that are no longer used */
+  g_array_set_size (priv->lines, col);
+
+  *x += priv->margin;
+  priv->cols = col;
 
   return rows;
 }
@@ -3354,34 +4041,80 @@ exo_icon_view_layout_rows (ExoIconView *icon_view,
                            gint         item_width,
                            gint        *y,
                            gint        *maximum_width,
-                           gint         max_cols)
+                           gint         max_cols,
+                           gint         first_line)
 {
-  GList *icons = icon_view->priv->items;
-  GList *items;
-  gint   row = 0;
-  gint   cols = 0;
+  ExoIconViewPrivate *priv = icon_view->priv;
+  ExoIconViewLine     line;
+  ExoIconViewLine    *old;
+  gint                n_lines = priv->lines->len;
+  gint                icons = 0;
+  gint                row = first_line;
+  gint                cols = priv->cols;
+
+  /* check if all rows are still valid */
+  if (G_UNLIKELY (n_lines > 0 && first_line >= n_lines))
+    {
+      *y = g_array_index (priv->lines, ExoIconViewLine, n_lines - 1).end + priv->margin;
+      return cols;
+    }
 
-  *y = icon_view->priv->margin;
+  /* continue with the first row that needs to be layouted */
+  if (G_LIKELY (first_line > 0))
+    {
+      old = &g_array_index (priv->lines, ExoIconViewLine, first_line);
+      icons = old->first;
+      *y = old->start;
+    }
+  else
+    {
+      *y = priv->margin;
+    }
 
   do
     {
+      line.first = icons;
+      line.start = *y;
+
       icons = exo_icon_view_layout_single_row (icon_view, icons,
                                                item_width, row,
                                                y, maximum_width, max_cols);
 
+      line.end = *y;
+
       /* count the number of columns in the first row */
       if (G_UNLIKELY (row == 0))
+        cols = icons;
+
+      /* if the row was layouted like before and no dirty items follow,
+       * the remaining rows are unaffected and we can stop here.
+       */
+      if (icons > priv->layout_dirty_last && row + 1 < n_lines)
         {
-          for (items = icon_view->priv->items, cols = 0; items != icons; items = items->next, ++cols)
-            ;
+          old = &g_array_index (priv->lines, ExoIconViewLine, row);
+          if (old->first == line.first && old->start == line.start
+              && old->end == line.end && old[1].first == icons)
+            {
+              *y = g_array_index (priv->lines, ExoIconViewLine, n_lines - 1).end + priv->margin;
+              return cols;
+            }
         }
 
+      /* update the line index */
+      if (row < (gint) priv->lines->len)
+        g_array_index (priv->lines, ExoIconViewLine, row) = line;
+      else
+        g_array_append_val (priv->lines, line);
+
       row++;
     }
-  while (icons != NULL);
+  while (icons < EXO_ICON_VIEW_N_ITEMS (icon_view));
 
-  *y += icon_view->priv->margin;
-  icon_view->priv->rows = row;
+  /* drop the rows that are no longer used */
+  g_array_set_size (priv->lines, row);
+
+  *y += priv->margin;
+  priv->rows = row;
 
   return cols;
 }
@@ -3393,7 +4126,9 @@ exo_icon_view_layout (ExoIconView *icon_view)
 {
   ExoIconViewPrivate *priv = icon_view->priv;
   ExoIconViewItem    *item;
-  GList              *icons;
+  gboolean            incremental;
+  gint                first_line;
+  gint                n;
   gint                maximum_height = 0;
   gint                maximum_width = 0;
   gint                item_height;
@@ -3407,27 +4142,78 @@ exo_icon_view_layout (ExoIconView *icon_view)
   if (G_UNLIKELY (priv->model == NULL))
     return;
 
+  /* the items are rebuilt and layouted on thaw */
+  if (G_UNLIKELY (priv->frozen_items != NULL))
+    return;
+
   gtk_widget_get_allocation (GTK_WIDGET (icon_view), &allocation);
 
   gtk_widget_get_preferred_width (GTK_WIDGET (icon_view), NULL, &requisition.width);
   gtk_widget_get_preferred_height (GTK_WIDGET (icon_view), NULL, &requisition.height);
 
+  /* remember the cell configuration the items are measured with */
+  if (G_UNLIKELY (priv->size_key == NULL))
+    priv->size_key = exo_icon_view_get_size_key (icon_view);
+
+  /* we can continue from the previous layout if only some items
+   * were added, removed or resized since, otherwise everything
+   * has to be layouted again.
+   */
+  incremental = (priv->layout_dirty_first > 0
+                 && !priv->layout_size_dirty
+                 && priv->lines->len > 0
+                 && priv->layout_width == allocation.width
+                 && priv->layout_height == allocation.height
+                 && priv->layout_direction == gtk_widget_get_direction (GTK_WIDGET (icon_view)));
+
+  /* items before the first dirty one were measured by the previous layout */
+  n = incremental ? MIN (priv->layout_dirty_first, EXO_ICON_VIEW_N_ITEMS (icon_view)) : 0;
+
   /* determine the layout mode */
   if (G_LIKELY (priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
     {
       /* calculate item sizes on-demand */
       item_width = priv->item_width;
-      if (item_width < 0)
+      if (G_UNLIKELY (priv->fixed_item_size))
+        {
+          /* estimate the item size from a sample of the items */
+          exo_icon_view_sample_item_size (icon_view);
+          if (item_width < 0)
+            item_width = priv->fixed_item_width;
+        }
+      else if (item_width < 0)
         {
-          for (icons = priv->items; icons != NULL; icons = icons->next)
+          if (G_LIKELY (incremental))
+            item_width = priv->layout_item_size;
+
+          for (; n < EXO_ICON_VIEW_N_ITEMS (icon_view); ++n)
             {
-              item = icons->data;
+              item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
               exo_icon_view_calculate_item_size (icon_view, item);
               item_width = MAX (item_width, item->area.width);
             }
         }
 
-      cols = exo_icon_view_layout_rows (icon_view, item_width, &y, &maximum_width, 0);
+      /* a different item width affects all rows */
+      if (item_width != priv->layout_item_size)
+        incremental = FALSE;
+
+      if (G_LIKELY (incremental))
+        {
+          /* continue with the row of the item preceding the first
+           * dirty item, which might now have space for more items.
+           */
+          first_line = (priv->layout_dirty_first == G_MAXINT) ? (gint) priv->lines->len
+                     : exo_icon_view_find_line (icon_view, MIN (priv->layout_dirty_first, EXO_ICON_VIEW_N_ITEMS (icon_view)) - 1);
+          maximum_width = priv->width;
+          cols = exo_icon_view_layout_rows (icon_view, item_width, &y, &maximum_width, priv->layout_line_limit, first_line);
+        }
+      else
+        {
+          priv->layout_dirty_last = G_MAXINT;
+          priv->layout_line_limit = 0;
+          cols = exo_icon_view_layout_rows (icon_view, item_width, &y, &maximum_width, 0, 0);
+        }
 
       /* If, by adding another column, we increase the height of the icon view, thus forcing a
        * vertical scrollbar to appear that would prevent the last column from being able to fit,
@@ -3436,24 +4222,55 @@ exo_icon_view_layout (ExoIconView *icon_view)
       if (cols == priv->cols + 1 && y > allocation.height &&
           priv->height <= allocation.height)
         {
-          cols = exo_icon_view_layout_rows (icon_view, item_width, &y, &maximum_width, priv->cols);
+          priv->layout_dirty_last = G_MAXINT;
+          priv->layout_line_limit = priv->cols;
+          cols = exo_icon_view_layout_rows (icon_view, item_width, &y, &maximum_width, priv->cols, 0);
         }
 
       priv->width = maximum_width;
       priv->height = y;
       priv->cols = cols;
+      priv->layout_item_size = item_width;
     }
   else
     {
       /* calculate item sizes on-demand */
-      for (icons = priv->items, item_height = 0; icons != NULL; icons = icons->next)
+      if (G_UNLIKELY (priv->fixed_item_size))
         {
-          item = icons->data;
-          exo_icon_view_calculate_item_size (icon_view, item);
-          item_height = MAX (item_height, item->area.height);
+          /* estimate the item size from a sample of the items */
+          exo_icon_view_sample_item_size (icon_view);
+          item_height = priv->fixed_item_height;
+        }
+      else
+        {
+          for (item_height = incremental ? priv->layout_item_size : 0; n < EXO_ICON_VIEW_N_ITEMS (icon_view); ++n)
+            {
+              item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
+              exo_icon_view_calculate_item_size (icon_view, item);
+              item_height = MAX (item_height, item->area.height);
+            }
         }
 
-      rows = exo_icon_view_layout_cols (icon_view, item_height, &x, &maximum_height, 0);
+      /* a different item height affects all columns */
+      if (item_height != priv->layout_item_size)
+        incremental = FALSE;
+
+      if (G_LIKELY (incremental))
+        {
+          /* continue with the column of the item preceding the first
+           * dirty item, which might now have space for more items.
+           */
+          first_line = (priv->layout_dirty_first == G_MAXINT) ? (gint) priv->lines->len
+                     : exo_icon_view_find_line (icon_view, MIN (priv->layout_dirty_first, EXO_ICON_VIEW_N_ITEMS (icon_view)) - 1);
+          maximum_height = priv->height;
+          rows = exo_icon_view_layout_cols (icon_view, item_height, &x, &maximum_height, priv->layout_line_limit, first_line);
+        }
+      else
+        {
+          priv->layout_dirty_last = G_MAXINT;
+          priv->layout_line_limit = 0;
+          rows = exo_icon_view_layout_cols (icon_view, item_height, &x, &maximum_height, 0, 0);
+        }
 
       /* If, by adding another row, we increase the width of the icon view, thus forcing a
        * horizontal scrollbar to appear that would prevent the last row from being able to fit,
@@ -3462,14 +4279,25 @@ exo_icon_view_layout (ExoIconView *icon_view)
       if (rows == priv->rows + 1 && x > allocation.width &&
           priv->width <= allocation.width)
         {
-          rows = exo_icon_view_layout_cols (icon_view, item_height, &x, &maximum_height, priv->rows);
+          priv->layout_dirty_last = G_MAXINT;
+          priv->layout_line_limit = priv->rows;
+          rows = exo_icon_view_layout_cols (icon_view, item_height, &x, &maximum_height, priv->rows, 0);
         }
 
       priv->height = maximum_height;
       priv->width = x;
       priv->rows = rows;
+      priv->layout_item_size = item_height;
     }
 
+  /* remember the parameters of this layout */
+  priv->layout_width = allocation.width;
+  priv->layout_height = allocation.height;
+  priv->layout_direction = gtk_widget_get_direction (GTK_WIDGET (icon_view));
+  priv->layout_dirty_first = G_MAXINT;
+  priv->layout_dirty_last = -1;
+  priv->layout_size_dirty = FALSE;
+
   exo_icon_view_set_adjustment_upper (priv->hadjustment, priv->width);
   exo_icon_view_set_adjustment_upper (priv->vadjustment, priv->height);
 
@@ -3499,6 +4327,8 @@ exo_icon_view_get_cell_area (ExoIconView         *icon_view,
                              ExoIconViewCellInfo *info,
                              GdkRectangle        *cell_area)
 {
+  exo_icon_view_refine_item (icon_view, item);
+
   if (icon_view->priv->orientation == GTK_ORIENTATION_HORIZONTAL)
     {
       cell_area->x = item->box[info->position].x - item->before[info->position];
@@ -3517,33 +4347,111 @@ exo_icon_view_get_cell_area (ExoIconView         *icon_view,
 
 
 
+static guint
+exo_icon_view_text_extents_hash (gconstpointer key)
+{
+  const ExoIconViewTextExtents *extents = key;
+
+  return g_str_hash (extents->text) ^ ((guint) extents->wrap_width << 2) ^ (extents->markup << 1) ^ extents->vertical;
+}
+
+
+
+static gboolean
+exo_icon_view_text_extents_equal (gconstpointer a,
+                                  gconstpointer b)
+{
+  const ExoIconViewTextExtents *extents_a = a;
+  const ExoIconViewTextExtents *extents_b = b;
+
+  return (extents_a->wrap_width == extents_b->wrap_width
+       && extents_a->markup == extents_b->markup
+       && extents_a->vertical == extents_b->vertical
+       && strcmp (extents_a->text, extents_b->text) == 0);
+}
+
+
+
+static void
+exo_icon_view_text_extents_free (gpointer data)
+{
+  ExoIconViewTextExtents *extents = data;
+
+  g_free (extents->text);
+  g_slice_free (ExoIconViewTextExtents, extents);
+}
+
+
+
+static gboolean
+exo_icon_view_lookup_text_extents (ExoIconView         *icon_view,
+                                   ExoIconViewCellInfo *info,
+                                   GdkRectangle        *box)
+{
+  const ExoIconViewTextExtents *extents;
+  ExoIconViewTextExtents        key;
+
+  /* only strings from the model are known, cell data functions may set anything */
+  if (info->text_extents == NULL || info->text == NULL || info->func != NULL)
+    return FALSE;
+
+  key.text = info->text;
+  key.wrap_width = info->wrap_width;
+  key.markup = info->text_is_markup;
+  key.vertical = (icon_view->priv->orientation == GTK_ORIENTATION_VERTICAL);
+
+  icon_view->priv->text_extents_lookups++;
+  extents = g_hash_table_lookup (info->text_extents, &key);
+  if (extents == NULL)
+    return FALSE;
+
+  icon_view->priv->text_extents_hits++;
+  box->width = extents->width;
+  box->height = extents->height;
+
+  return TRUE;
+}
+
+
+
+static void
+exo_icon_view_store_text_extents (ExoIconView         *icon_view,
+                                  ExoIconViewCellInfo *info,
+                                  const GdkRectangle  *box)
+{
+  ExoIconViewTextExtents *extents;
+
+  if (info->text_extents == NULL || info->text == NULL || info->func != NULL)
+    return;
+
+  /* start over instead of growing without bounds */
+  if (G_UNLIKELY (g_hash_table_size (info->text_extents) >= (guint) MAX (EXO_ICON_VIEW_TEXT_EXTENTS_MIN, 2 * EXO_ICON_VIEW_N_ITEMS (icon_view))))
+    g_hash_table_remove_all (info->text_extents);
+
+  extents = g_slice_new (ExoIconViewTextExtents);
+  extents->text = g_strdup (info->text);
+  extents->wrap_width = info->wrap_width;
+  extents->markup = info->text_is_markup;
+  extents->vertical = (icon_view->priv->orientation == GTK_ORIENTATION_VERTICAL);
+  extents->width = box->width;
+  extents->height = box->height;
+  g_hash_table_add (info->text_extents, extents);
+}
+
+
+
 static void
 exo_icon_view_calculate_item_size (ExoIconView     *icon_view,
                                    ExoIconViewItem *item)
 {
   ExoIconViewCellInfo *info;
   GList               *lp;
-  gchar               *buffer;
 
   if (G_LIKELY (item->area.width != -1))
     return;
 
   if (G_UNLIKELY (item->n_cells != icon_view->priv->n_cells))
-    {
-      /* apply the new cell size */
-      item->n_cells = icon_view->priv->n_cells;
-
-      /* release the memory chunk (if any) */
-      g_free (item->box);
-
-      /* allocate a single memory chunk for box, after and before */
-      buffer = g_malloc0 (item->n_cells * (sizeof (GdkRectangle) + 2 * sizeof (gint)));
-
-      /* assign the memory */
-      item->box = (GdkRectangle *) buffer;
-      item->after = (gint *) (buffer + item->n_cells * sizeof (GdkRectangle));
-      item->before = item->after + item->n_cells;
-    }
+    exo_icon_view_item_set_n_cells (icon_view, item);
 
   exo_icon_view_set_cell_data (icon_view, item);
 
@@ -3555,6 +4463,8 @@ exo_icon_view_calculate_item_size (ExoIconView     *icon_view,
       if (G_UNLIKELY (!gtk_cell_renderer_get_visible (info->cell)))
         continue;
 
+      /* text layout is expensive, reuse the size measured for the same string */
+      if (!info->is_text || !exo_icon_view_lookup_text_extents (icon_view, info, &item->box[info->position]))
       {
         GtkRequisition req;
 
@@ -3580,6 +4490,9 @@ exo_icon_view_calculate_item_size (ExoIconView     *icon_view,
             item->box[info->position].width = req.width;
             item->box[info->position].height = req.height;
           }
+
+        if (info->is_text)
+          exo_icon_view_store_text_extents (icon_view, info, &item->box[info->position]);
       }
 
       if (icon_view->priv->orientation == GTK_ORIENTATION_HORIZONTAL)
@@ -3703,242 +4616,1923 @@ exo_icon_view_calculate_item_size2 (ExoIconView     *icon_view,
 static void
 exo_icon_view_invalidate_sizes (ExoIconView *icon_view)
 {
-  GList *lp;
+  ExoIconViewItem *item;
+  gint             n;
 
-  for (lp = icon_view->priv->items; lp != NULL; lp = lp->next)
-    EXO_ICON_VIEW_ITEM (lp->data)->area.width = -1;
+  for (n = 0; n < EXO_ICON_VIEW_N_ITEMS (icon_view); ++n)
+    {
+      item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, n);
+      if (G_LIKELY (item != NULL))
+        item->area.width = -1;
+    }
+  exo_icon_view_drop_size_caches (icon_view);
+  icon_view->priv->fixed_sample_valid = FALSE;
+  icon_view->priv->cell_data_item = NULL;
   exo_icon_view_queue_layout (icon_view);
 }
 
 
 
+static gchar*
+exo_icon_view_get_size_key (ExoIconView *icon_view)
+{
+  const ExoIconViewAttribute *attribute;
+  ExoIconViewCellInfo        *info;
+  GParamSpec                **pspecs;
+  gboolean                    markup;
+  GString                    *key;
+  GValue                      value = { 0, };
+  GList                      *lp;
+  gchar                      *contents;
+  guint                       n_pspecs;
+  guint                       n, m;
+
+  /* the fixed item size mode measures only few items anyway, and
+   * cell data functions may configure the cells for every item
+   */
+  if (icon_view->priv->fixed_item_size)
+    return NULL;
+  for (lp = icon_view->priv->cell_list; lp != NULL; lp = lp->next)
+    if (EXO_ICON_VIEW_CELL_INFO (lp->data)->func != NULL)
+      return NULL;
+
+  key = g_string_new (NULL);
+  g_string_append_printf (key, "%d %d", icon_view->priv->orientation, gtk_widget_get_scale_factor (GTK_WIDGET (icon_view)));
+
+  /* the cells are described by the values of their properties not bound to the model */
+  for (lp = icon_view->priv->cell_list; lp != NULL; lp = lp->next)
+    {
+      info = EXO_ICON_VIEW_CELL_INFO (lp->data);
+      g_string_append_printf (key, "|%s", G_OBJECT_TYPE_NAME (info->cell));
+
+      pspecs = g_object_class_list_properties (G_OBJECT_GET_CLASS (info->cell), &n_pspecs);
+      for (n = 0, markup = FALSE; info->attributes != NULL && n < info->attributes->len; ++n)
+        if (strcmp (g_array_index (info->attributes, ExoIconViewAttribute, n).pspec->name, "markup") == 0)
+          markup = TRUE;
+
+      for (n = 0; n < n_pspecs; ++n)
+        {
+          if ((pspecs[n]->flags & G_PARAM_READABLE) == 0)
+            continue;
+
+          /* only plain values can be compared, objects and boxed values are copied or per item */
+          switch (G_TYPE_FUNDAMENTAL (pspecs[n]->value_type))
+            {
+            case G_TYPE_BOOLEAN:
+            case G_TYPE_CHAR:
+            case G_TYPE_UCHAR:
+            case G_TYPE_INT:
+            case G_TYPE_UINT:
+            case G_TYPE_LONG:
+            case G_TYPE_ULONG:
+            case G_TYPE_INT64:
+            case G_TYPE_UINT64:
+            case G_TYPE_ENUM:
+            case G_TYPE_FLAGS:
+            case G_TYPE_FLOAT:
+            case G_TYPE_DOUBLE:
+            case G_TYPE_STRING:
+              break;
+
+            default:
+              continue;
+            }
+
+          /* the text of a cell with bound markup is set for every item */
+          if (markup && strcmp (pspecs[n]->name, "text") == 0)
+            continue;
+
+          for (m = 0; info->attributes != NULL && m < info->attributes->len; ++m)
+            {
+              attribute = &g_array_index (info->attributes, ExoIconViewAttribute, m);
+              if (strcmp (attribute->pspec->name, pspecs[n]->name) == 0)
+                break;
+            }
+          if (info->attributes != NULL && m < info->attributes->len)
+            continue;
+
+          g_value_init (&value, pspecs[n]->value_type);
+          g_object_get_property (G_OBJECT (info->cell), pspecs[n]->name, &value);
+          contents = g_strdup_value_contents (&value);
+          g_string_append_printf (key, " %s=%s", pspecs[n]->name, contents);
+          g_free (contents);
+          g_value_unset (&value);
+        }
+
+      g_free (pspecs);
+    }
+
+  return g_string_free (key, FALSE);
+}
+
+
+
 static void
-exo_icon_view_paint_item (ExoIconView     *icon_view,
-                          ExoIconViewItem *item,
-                          cairo_t         *cr,
-                          gint             x,
-                          gint             y,
-                          gboolean         draw_focus)
+exo_icon_view_size_cache_free (gpointer data)
 {
-  GtkCellRendererState flags = 0;
-  ExoIconViewCellInfo *info;
-  GtkStateFlags        state;
-  GdkRectangle         cell_area;
-  GdkRectangle         aligned_area;
-  GtkStyleContext     *style_context;
-  GList               *lp;
+  ExoIconViewSizeCache *cache = data;
 
-  if (G_UNLIKELY (icon_view->priv->model == NULL))
-    return;
+  g_array_free (cache->sizes, TRUE);
+  g_free (cache->key);
+  g_slice_free (ExoIconViewSizeCache, cache);
+}
 
-  exo_icon_view_set_cell_data (icon_view, item);
 
-  style_context = gtk_widget_get_style_context (GTK_WIDGET (icon_view));
-  state = gtk_widget_get_state_flags (GTK_WIDGET (icon_view));
 
-  gtk_style_context_save (style_context);
-  gtk_style_context_add_class (style_context, GTK_STYLE_CLASS_CELL);
+static void
+exo_icon_view_drop_size_caches (ExoIconView *icon_view)
+{
+  g_slist_free_full (icon_view->priv->size_caches, exo_icon_view_size_cache_free);
+  icon_view->priv->size_caches = NULL;
 
-  state &= ~(GTK_STATE_FLAG_SELECTED | GTK_STATE_FLAG_PRELIGHT);
+  g_free (icon_view->priv->size_key);
+  icon_view->priv->size_key = NULL;
+}
 
-  if (G_UNLIKELY (EXO_ICON_VIEW_FLAG_SET (icon_view, EXO_ICON_VIEW_DRAW_KEYFOCUS)
-    && (state & GTK_STATE_FLAG_FOCUSED) && item == icon_view->priv->cursor_item))
-    {
-      flags |= GTK_CELL_RENDERER_FOCUSED;
+
+
+static void
+exo_icon_view_save_sizes (ExoIconView *icon_view)
+{
+  ExoIconViewSizeCache *cache;
+  ExoIconViewItem      *item;
+  GSList               *lp;
+  gint                 *sizes;
+  gint                  n, i;
+
+  cache = g_slice_new (ExoIconViewSizeCache);
+  cache->key = icon_view->priv->size_key;
+  cache->n_cells = icon_view->priv->n_cells;
+  cache->sizes = g_array_sized_new (FALSE, FALSE, sizeof (gint), 2 * cache->n_cells * EXO_ICON_VIEW_N_ITEMS (icon_view));
+  g_array_set_size (cache->sizes, 2 * cache->n_cells * EXO_ICON_VIEW_N_ITEMS (icon_view));
+  icon_view->priv->size_key = NULL;
+
+  /* store the width and height of every cell, or -1 if the item was not measured */
+  sizes = (gint *) cache->sizes->data;
+  for (n = 0; n < EXO_ICON_VIEW_N_ITEMS (icon_view); ++n)
+    {
+      item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, n);
+      for (i = 0; i < cache->n_cells; ++i)
+        {
+          if (item != NULL && item->area.width != -1 && item->n_cells == cache->n_cells)
+            {
+              *sizes++ = MAX (item->box[i].width, 0);
+              *sizes++ = MAX (item->box[i].height, 0);
+            }
+          else
+            {
+              *sizes++ = -1;
+              *sizes++ = -1;
+            }
+        }
     }
 
-  if (G_UNLIKELY (item->selected))
+  /* forget the least recently used configuration */
+  icon_view->priv->size_caches = g_slist_prepend (icon_view->priv->size_caches, cache);
+  lp = g_slist_nth (icon_view->priv->size_caches, EXO_ICON_VIEW_SIZE_CACHES - 1);
+  if (lp != NULL && lp->next != NULL)
     {
-      state |= GTK_STATE_FLAG_SELECTED;
-      flags |= GTK_CELL_RENDERER_SELECTED;
+      g_slist_free_full (lp->next, exo_icon_view_size_cache_free);
+      lp->next = NULL;
     }
+}
 
-  if (G_UNLIKELY (icon_view->priv->prelit_item == item))
+
+
+static void
+exo_icon_view_restore_item_area (ExoIconView     *icon_view,
+                                 ExoIconViewItem *item,
+                                 const gboolean  *visible)
+{
+  gint spacing = icon_view->priv->spacing;
+  gint i;
+
+  /* same as exo_icon_view_calculate_item_size(), but from the known cell sizes */
+  item->area.width = 0;
+  item->area.height = 0;
+  for (i = 0; i < item->n_cells; ++i)
     {
-      state |= GTK_STATE_FLAG_PRELIGHT;
-      flags |= GTK_CELL_RENDERER_PRELIT;
+      if (G_UNLIKELY (!visible[i]))
+        continue;
+
+      if (icon_view->priv->orientation == GTK_ORIENTATION_HORIZONTAL)
+        {
+          item->area.width += item->box[i].width + (i > 0 ? spacing : 0);
+          item->area.height = MAX (item->area.height, item->box[i].height);
+        }
+      else
+        {
+          item->area.width = MAX (item->area.width, item->box[i].width);
+          item->area.height += item->box[i].height + (i > 0 ? spacing : 0);
+        }
     }
+}
 
-  gtk_style_context_set_state (style_context, state);
 
-  for (lp = icon_view->priv->cell_list; lp != NULL; lp = lp->next)
+
+static void
+exo_icon_view_invalidate_geometry (ExoIconView *icon_view)
+{
+  ExoIconViewSizeCache *cache = NULL;
+  ExoIconViewItem      *item;
+  gboolean              changed;
+  gboolean             *visible;
+  GSList               *sp;
+  GList                *lp;
+  gchar                *key;
+  gint                 *sizes;
+  gint                  n_cells = icon_view->priv->n_cells;
+  gint                  n, i;
+
+  /* without a description of the cells, all items must be measured again */
+  key = exo_icon_view_get_size_key (icon_view);
+  if (G_UNLIKELY (key == NULL))
     {
-      info = EXO_ICON_VIEW_CELL_INFO (lp->data);
+      exo_icon_view_invalidate_sizes (icon_view);
+      return;
+    }
 
-      cairo_save (cr);
+  /* if the cells were not reconfigured, only the layout changed */
+  changed = (icon_view->priv->size_key == NULL || strcmp (icon_view->priv->size_key, key) != 0);
+  if (G_LIKELY (changed))
+    {
+      /* keep the current sizes for when the configuration is restored */
+      if (G_LIKELY (icon_view->priv->size_key != NULL && n_cells > 0))
+        exo_icon_view_save_sizes (icon_view);
 
-      if (G_UNLIKELY (!gtk_cell_renderer_get_visible (info->cell)))
-        continue;
+      /* check if the items were measured with the new configuration before */
+      for (sp = icon_view->priv->size_caches; sp != NULL; sp = sp->next)
+        if (strcmp (((ExoIconViewSizeCache *) sp->data)->key, key) == 0)
+          break;
 
-      exo_icon_view_get_cell_area (icon_view, item, info, &cell_area);
+      if (sp != NULL && ((ExoIconViewSizeCache *) sp->data)->n_cells == n_cells)
+        {
+          cache = sp->data;
+          icon_view->priv->size_caches = g_slist_delete_link (icon_view->priv->size_caches, sp);
+        }
 
-      cell_area.x = x - item->area.x + cell_area.x;
-      cell_area.y = y - item->area.y + cell_area.y;
+      g_free (icon_view->priv->size_key);
+      icon_view->priv->size_key = key;
+    }
+  else
+    {
+      g_free (key);
+    }
 
-      /* FIXME: this is bad CSS usage */
-      if (info->is_text)
-        {
-          gtk_cell_renderer_get_aligned_area (info->cell,
-                                              GTK_WIDGET (icon_view),
-                                              flags,
-                                              &cell_area,
-                                              &aligned_area);
+  visible = g_newa (gboolean, n_cells);
+  for (lp = icon_view->priv->cell_list; lp != NULL; lp = lp->next)
+    visible[EXO_ICON_VIEW_CELL_INFO (lp->data)->position] = gtk_cell_renderer_get_visible (EXO_ICON_VIEW_CELL_INFO (lp->data)->cell);
 
-          gtk_render_background (style_context, cr,
-                                 aligned_area.x, aligned_area.y,
-                                 aligned_area.width, aligned_area.height);
+  /* derive the item sizes from the known cell sizes, without asking the renderers */
+  for (n = 0; n < EXO_ICON_VIEW_N_ITEMS (icon_view); ++n)
+    {
+      item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, n);
+      if (G_UNLIKELY (item == NULL))
+        continue;
 
-          gtk_render_frame (style_context, cr,
-                            aligned_area.x, aligned_area.y,
-                            aligned_area.width, aligned_area.height);
+      if (cache != NULL)
+        {
+          sizes = &g_array_index (cache->sizes, gint, 2 * n_cells * n);
+          if (G_UNLIKELY (sizes[0] == -1 || item->n_cells != n_cells))
+            {
+              item->area.width = -1;
+              continue;
+            }
 
-          /* draw outline if focused */
-          if (flags & GTK_CELL_RENDERER_FOCUSED)
+          for (i = 0; i < n_cells; ++i)
             {
-              gtk_render_focus (style_context, cr,
-                                aligned_area.x, aligned_area.y,
-                                aligned_area.width, aligned_area.height);
+              item->box[i].width = sizes[2 * i];
+              item->box[i].height = sizes[2 * i + 1];
             }
         }
+      else if (changed || item->area.width == -1 || item->n_cells != n_cells)
+        {
+          item->area.width = -1;
+          continue;
+        }
+
+      exo_icon_view_restore_item_area (icon_view, item, visible);
+    }
+
+  if (cache != NULL)
+    exo_icon_view_size_cache_free (cache);
+
+  icon_view->priv->cell_data_item = NULL;
+  exo_icon_view_queue_layout (icon_view);
+}
+
+
+
+static void
+exo_icon_view_size_caches_insert (ExoIconView *icon_view,
+                                  gint         index)
+{
+  ExoIconViewSizeCache *cache;
+  GSList               *sp;
+  gint                 *unmeasured;
+  gint                  i;
+
+  for (sp = icon_view->priv->size_caches; sp != NULL; sp = sp->next)
+    {
+      cache = sp->data;
+      unmeasured = g_newa (gint, 2 * cache->n_cells);
+      for (i = 0; i < 2 * cache->n_cells; ++i)
+        unmeasured[i] = -1;
+      g_array_insert_vals (cache->sizes, 2 * cache->n_cells * index, unmeasured, 2 * cache->n_cells);
+    }
+}
+
+
+
+static void
+exo_icon_view_size_caches_delete (ExoIconView *icon_view,
+                                  gint         index)
+{
+  ExoIconViewSizeCache *cache;
+  GSList               *sp;
+
+  for (sp = icon_view->priv->size_caches; sp != NULL; sp = sp->next)
+    {
+      cache = sp->data;
+      g_array_remove_range (cache->sizes, 2 * cache->n_cells * index, 2 * cache->n_cells);
+    }
+}
+
+
+
+static void
+exo_icon_view_size_caches_forget (ExoIconView *icon_view,
+                                  gint         index)
+{
+  ExoIconViewSizeCache *cache;
+  GSList               *sp;
+
+  /* the item must be measured again for every configuration */
+  for (sp = icon_view->priv->size_caches; sp != NULL; sp = sp->next)
+    {
+      cache = sp->data;
+      if (G_LIKELY (cache->n_cells > 0))
+        g_array_index (cache->sizes, gint, 2 * cache->n_cells * index) = -1;
+    }
+}
+
+
+
+static void
+exo_icon_view_size_caches_reorder (ExoIconView *icon_view,
+                                   gint         length,
+                                   const gint  *new_order)
+{
+  ExoIconViewSizeCache *cache;
+  GSList               *sp;
+  GArray               *sizes;
+  gint                  stride;
+  gint                  n;
+
+  for (sp = icon_view->priv->size_caches; sp != NULL; sp = sp->next)
+    {
+      cache = sp->data;
+      stride = 2 * cache->n_cells;
+
+      /* new_order[n] is the former position of the item now at position n */
+      sizes = g_array_sized_new (FALSE, FALSE, sizeof (gint), stride * length);
+      for (n = 0; n < length; ++n)
+        g_array_append_vals (sizes, &g_array_index (cache->sizes, gint, stride * new_order[n]), stride);
+
+      g_array_free (cache->sizes, TRUE);
+      cache->sizes = sizes;
+    }
+}
+
+
+
+static void
+exo_icon_view_sample_item_size (ExoIconView *icon_view)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  ExoIconViewItem    *item;
+  GdkRectangle        area;
+  gint                n_items = EXO_ICON_VIEW_N_ITEMS (icon_view);
+  gint                width = 0;
+  gint                height = 0;
+  gint                step;
+  gint                n, i;
+
+  /* check if the sample is still valid */
+  if (G_LIKELY (priv->fixed_sample_valid))
+    return;
+
+  /* allocate a single memory chunk for the cell sizes */
+  priv->fixed_cell_width = g_renew (gint, priv->fixed_cell_width, 2 * priv->n_cells);
+  priv->fixed_cell_height = priv->fixed_cell_width + priv->n_cells;
+  for (i = 0; i < priv->n_cells; ++i)
+    {
+      priv->fixed_cell_width[i] = 0;
+      priv->fixed_cell_height[i] = 0;
+    }
+
+  /* measure items spread evenly over the model */
+  step = MAX (1, n_items / EXO_ICON_VIEW_FIXED_SAMPLE_SIZE);
+  for (n = 0; n < n_items; n += step)
+    {
+      item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
+
+      /* measure the item, but keep its place in the layout */
+      area = item->area;
+      item->area.width = -1;
+      exo_icon_view_calculate_item_size (icon_view, item);
+
+      width = MAX (width, item->area.width);
+      height = MAX (height, item->area.height);
+
+      for (i = 0; i < priv->n_cells; ++i)
+        {
+          priv->fixed_cell_width[i] = MAX (priv->fixed_cell_width[i], item->box[i].width);
+          priv->fixed_cell_height[i] = MAX (priv->fixed_cell_height[i], item->box[i].height);
+        }
+
+      item->area = area;
+      item->needs_refine = TRUE;
+    }
+
+  /* the size across the lines is determined by the largest cells,
+   * just like exo_icon_view_calculate_item_size2() does.
+   */
+  if (G_LIKELY (priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
+    {
+      for (i = 0, height = 0; i < priv->n_cells; ++i)
+        {
+          if (priv->orientation == GTK_ORIENTATION_HORIZONTAL)
+            height = MAX (height, priv->fixed_cell_height[i]);
+          else
+            height += priv->fixed_cell_height[i] + (i > 0 ? priv->spacing : 0);
+        }
+    }
+  else
+    {
+      for (i = 0, width = 0; i < priv->n_cells; ++i)
+        {
+          if (priv->orientation == GTK_ORIENTATION_HORIZONTAL)
+            width += priv->fixed_cell_width[i] + (i > 0 ? priv->spacing : 0);
+          else
+            width = MAX (width, priv->fixed_cell_width[i]);
+        }
+    }
+
+  priv->fixed_item_width = width;
+  priv->fixed_item_height = height;
+  priv->fixed_sample_valid = TRUE;
+}
+
+
+
+static void
+exo_icon_view_refine_item (ExoIconView     *icon_view,
+                           ExoIconViewItem *item)
+{
+  GdkRectangle area;
+
+  /* check if the item was placed with the estimated size */
+  if (G_LIKELY (!icon_view->priv->fixed_item_size || !item->needs_refine))
+    return;
+
+  /* the sample is gone if sizes were invalidated since the layout */
+  exo_icon_view_sample_item_size (icon_view);
+
+  /* measure the cells of the item */
+  area = item->area;
+  item->area.width = -1;
+  exo_icon_view_calculate_item_size (icon_view, item);
+
+  /* align the cells within the fixed item area */
+  item->area = area;
+  exo_icon_view_calculate_item_size2 (icon_view, item,
+                                      icon_view->priv->fixed_cell_width,
+                                      icon_view->priv->fixed_cell_height);
+  item->area = area;
+  item->needs_refine = FALSE;
+}
+
+
+
+static void
+exo_icon_view_paint_item (ExoIconView     *icon_view,
+                          ExoIconViewItem *item,
+                          cairo_t         *cr,
+                          gint             x,
+                          gint             y,
+                          gboolean         draw_focus)
+{
+  GtkCellRendererState flags = 0;
+  ExoIconViewCellInfo *info;
+  GtkStateFlags        state;
+  GdkRectangle         cell_area;
+  GdkRectangle         aligned_area;
+  GtkStyleContext     *style_context;
+  GList               *lp;
+
+  if (G_UNLIKELY (icon_view->priv->model == NULL))
+    return;
+
+  exo_icon_view_set_cell_data (icon_view, item);
+
+  /* the caller saved the style context and added the cell class */
+  style_context = gtk_widget_get_style_context (GTK_WIDGET (icon_view));
+  state = gtk_widget_get_state_flags (GTK_WIDGET (icon_view));
+
+  state &= ~(GTK_STATE_FLAG_SELECTED | GTK_STATE_FLAG_PRELIGHT);
+
+  if (G_UNLIKELY (EXO_ICON_VIEW_FLAG_SET (icon_view, EXO_ICON_VIEW_DRAW_KEYFOCUS)
+    && (state & GTK_STATE_FLAG_FOCUSED) && item == icon_view->priv->cursor_item))
+    {
+      flags |= GTK_CELL_RENDERER_FOCUSED;
+    }
+
+  if (G_UNLIKELY (EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item)))
+    {
+      state |= GTK_STATE_FLAG_SELECTED;
+      flags |= GTK_CELL_RENDERER_SELECTED;
+    }
+
+  if (G_UNLIKELY (icon_view->priv->prelit_item == item))
+    {
+      state |= GTK_STATE_FLAG_PRELIGHT;
+      flags |= GTK_CELL_RENDERER_PRELIT;
+    }
+
+  /* neighbouring items mostly share the state of the previous one */
+  if (gtk_style_context_get_state (style_context) != state)
+    gtk_style_context_set_state (style_context, state);
+
+  for (lp = icon_view->priv->cell_list; lp != NULL; lp = lp->next)
+    {
+      info = EXO_ICON_VIEW_CELL_INFO (lp->data);
+
+      if (G_UNLIKELY (!gtk_cell_renderer_get_visible (info->cell)))
+        continue;
+
+      cairo_save (cr);
+
+      exo_icon_view_get_cell_area (icon_view, item, info, &cell_area);
+
+      cell_area.x = x - item->area.x + cell_area.x;
+      cell_area.y = y - item->area.y + cell_area.y;
+
+      /* FIXME: this is bad CSS usage */
+      if (info->is_text)
+        {
+          gtk_cell_renderer_get_aligned_area (info->cell,
+                                              GTK_WIDGET (icon_view),
+                                              flags,
+                                              &cell_area,
+                                              &aligned_area);
+
+          gtk_render_background (style_context, cr,
+                                 aligned_area.x, aligned_area.y,
+                                 aligned_area.width, aligned_area.height);
+
+          gtk_render_frame (style_context, cr,
+                            aligned_area.x, aligned_area.y,
+                            aligned_area.width, aligned_area.height);
+
+          /* draw outline if focused */
+          if (flags & GTK_CELL_RENDERER_FOCUSED)
+            {
+              gtk_render_focus (style_context, cr,
+                                aligned_area.x, aligned_area.y,
+                                aligned_area.width, aligned_area.height);
+            }
+        }
+
+      gtk_cell_renderer_render (info->cell,
+                                cr,
+                                GTK_WIDGET (icon_view),
+                                &cell_area, &cell_area, flags);
+
+      cairo_restore (cr);
+    }
+}
+
+
+
+static void
+exo_icon_view_queue_draw_item (ExoIconView     *icon_view,
+                               ExoIconViewItem *item)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  GdkRectangle        visible;
+  GdkRectangle        rect;
+  gint                focus_width;
+
+  if (G_UNLIKELY (priv->bin_window == NULL))
+    return;
+
+  gtk_widget_style_get (GTK_WIDGET (icon_view),
+                        "focus-line-width", &focus_width,
+                        NULL);
+
+  rect.x = item->area.x - focus_width;
+  rect.y = item->area.y - focus_width;
+  rect.width = item->area.width + 2 * focus_width;
+  rect.height = item->area.height + 2 * focus_width;
+
+  /* items outside the visible area are drawn once scrolled into view */
+  visible.x = gtk_adjustment_get_value (priv->hadjustment);
+  visible.y = gtk_adjustment_get_value (priv->vadjustment);
+  visible.width = gtk_adjustment_get_page_size (priv->hadjustment);
+  visible.height = gtk_adjustment_get_page_size (priv->vadjustment);
+  if (!gdk_rectangle_intersect (&rect, &visible, &rect))
+    return;
+
+  /* collect the damage and invalidate it at once before the next paint */
+  if (priv->pending_damage == NULL)
+    {
+      priv->pending_damage = cairo_region_create_rectangle (&rect);
+      gdk_frame_clock_request_phase (priv->frame_clock, GDK_FRAME_CLOCK_PHASE_BEFORE_PAINT);
+    }
+  else
+    {
+      cairo_region_union_rectangle (priv->pending_damage, &rect);
+    }
+}
+
+
+
+static void
+exo_icon_view_queue_selection_changed (ExoIconView *icon_view)
+{
+  /* the selection cannot be queried while the items are set aside,
+   * so the signal is emitted once they are rebuilt on thaw
+   */
+  if (G_UNLIKELY (icon_view->priv->frozen_items != NULL))
+    {
+      icon_view->priv->selection_changed_pending = TRUE;
+      return;
+    }
+
+  /* without a frame clock, there is no frame to wait for */
+  if (G_UNLIKELY (icon_view->priv->frame_clock == NULL))
+    {
+      g_signal_emit (G_OBJECT (icon_view), icon_view_signals[SELECTION_CHANGED], 0);
+      return;
+    }
+
+  /* emit "selection-changed" at most once per frame */
+  if (!icon_view->priv->selection_changed_pending)
+    {
+      icon_view->priv->selection_changed_pending = TRUE;
+      gdk_frame_clock_request_phase (icon_view->priv->frame_clock, GDK_FRAME_CLOCK_PHASE_BEFORE_PAINT);
+    }
+}
+
+
+
+static void
+exo_icon_view_flush_pending (ExoIconView *icon_view)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+
+  if (priv->pending_damage != NULL)
+    {
+      gdk_window_invalidate_region (priv->bin_window, priv->pending_damage, TRUE);
+      cairo_region_destroy (priv->pending_damage);
+      priv->pending_damage = NULL;
+    }
+
+  if (priv->selection_changed_pending && priv->frozen_items == NULL)
+    {
+      priv->selection_changed_pending = FALSE;
+      g_signal_emit (G_OBJECT (icon_view), icon_view_signals[SELECTION_CHANGED], 0);
+    }
+}
+
+
+
+static void
+exo_icon_view_before_paint (GdkFrameClock *frame_clock,
+                            ExoIconView   *icon_view)
+{
+  exo_icon_view_flush_pending (icon_view);
+}
+
+
+
+static gboolean
+layout_callback (gpointer user_data)
+{
+  ExoIconView *icon_view = EXO_ICON_VIEW (user_data);
+
+  exo_icon_view_layout (icon_view);
+
+  return FALSE;
+}
+
+
+
+static void
+layout_destroy (gpointer user_data)
+{
+  EXO_ICON_VIEW (user_data)->priv->layout_idle_id = 0;
+}
+
+
+
+static void
+exo_icon_view_queue_layout (ExoIconView *icon_view)
+{
+  /* layout all items */
+  exo_icon_view_queue_layout_from (icon_view, 0, G_MAXINT);
+}
+
+
+
+static void
+exo_icon_view_queue_layout_from (ExoIconView *icon_view,
+                                 gint         first_item,
+                                 gint         last_item)
+{
+  /* merge with the items that are already dirty */
+  icon_view->priv->layout_dirty_first = MIN (icon_view->priv->layout_dirty_first, first_item);
+  icon_view->priv->layout_dirty_last = MAX (icon_view->priv->layout_dirty_last, last_item);
+
+  /* while frozen, the layout is queued on thaw */
+  if (G_UNLIKELY (icon_view->priv->layout_idle_id == 0 && icon_view->priv->freeze_count == 0))
+    icon_view->priv->layout_idle_id = gdk_threads_add_idle_full (G_PRIORITY_DEFAULT_IDLE, layout_callback, icon_view, layout_destroy);
+}
+
+
+
+static void
+exo_icon_view_release_item_size (ExoIconView        *icon_view,
+                                 const GdkRectangle *area)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  gint                size;
+
+  /* only the sizes measured by the layout make up the common item size */
+  if (area->width < 0 || priv->fixed_item_size)
+    return;
+
+  if (G_LIKELY (priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
+    {
+      if (priv->item_width >= 0)
+        return;
+      size = area->width;
+    }
+  else
+    {
+      size = area->height;
+    }
+
+  /* the largest item is gone, so the incremental layout cannot start
+   * from the previous size, the remaining items may all be smaller
+   */
+  if (size >= priv->layout_item_size)
+    priv->layout_size_dirty = TRUE;
+}
+
+
+
+static void
+exo_icon_view_set_cursor_item (ExoIconView     *icon_view,
+                               ExoIconViewItem *item,
+                               gint             cursor_cell)
+{
+  if (icon_view->priv->cursor_item == item &&
+      (cursor_cell < 0 || cursor_cell == icon_view->priv->cursor_cell))
+    return;
+
+  if (icon_view->priv->cursor_item != NULL)
+    exo_icon_view_queue_draw_item (icon_view, icon_view->priv->cursor_item);
+
+  icon_view->priv->cursor_item = item;
+  if (cursor_cell >= 0)
+    icon_view->priv->cursor_cell = cursor_cell;
+
+  exo_icon_view_queue_draw_item (icon_view, item);
+}
+
+
+
+static gint
+exo_icon_view_find_line (const ExoIconView *icon_view,
+                         gint               item_index)
+{
+  const ExoIconViewLine *lines = (const ExoIconViewLine *) icon_view->priv->lines->data;
+  gint                   lower;
+  gint                   upper;
+  gint                   mid;
+
+  /* lookup the last line that starts at or before the item */
+  for (lower = 0, upper = icon_view->priv->lines->len; upper - lower > 1; )
+    {
+      mid = (lower + upper) / 2;
+      if (lines[mid].first <= item_index)
+        lower = mid;
+      else
+        upper = mid;
+    }
+
+  return lower;
+}
+
+
+
+static gint
+exo_icon_view_get_item_line (const ExoIconView     *icon_view,
+                             const ExoIconViewItem *item)
+{
+  const ExoIconViewLine *lines = (const ExoIconViewLine *) icon_view->priv->lines->data;
+  gint                   n_lines = icon_view->priv->lines->len;
+  gint                   line;
+
+  /* the row (or column) of the item is its line, unless the layout is outdated */
+  line = (icon_view->priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS) ? item->row : item->col;
+  if (G_UNLIKELY (line < 0 || line >= n_lines || lines[line].first > item->index
+               || (line + 1 < n_lines && lines[line + 1].first <= item->index)))
+    line = exo_icon_view_find_line (icon_view, item->index);
+
+  return line;
+}
+
+
+
+static ExoIconViewItem*
+exo_icon_view_get_item_on_line (ExoIconView *icon_view,
+                                gint         line,
+                                gint         position)
+{
+  const ExoIconViewLine *lines = (const ExoIconViewLine *) icon_view->priv->lines->data;
+  ExoIconViewItem       *item;
+  gboolean               reversed;
+  gint                   n_lines = icon_view->priv->lines->len;
+  gint                   first;
+  gint                   last;
+  gint                   lower;
+  gint                   upper;
+  gint                   mid;
+  gint                   n;
+
+  if (G_UNLIKELY (line < 0 || line >= n_lines))
+    return NULL;
+
+  first = MIN (lines[line].first, EXO_ICON_VIEW_N_ITEMS (icon_view));
+  last = (line + 1 < n_lines) ? MIN (lines[line + 1].first, EXO_ICON_VIEW_N_ITEMS (icon_view)) : EXO_ICON_VIEW_N_ITEMS (icon_view);
+
+  /* the position is the column of an item in a row, or the row of an
+   * item in a column, and the columns are reversed in a right-to-left row
+   */
+  reversed = (icon_view->priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS && icon_view->priv->layout_direction == GTK_TEXT_DIR_RTL);
+
+  /* every item takes exactly one position with a fixed item size */
+  if (G_UNLIKELY (icon_view->priv->fixed_item_size))
+    {
+      n = reversed ? (last - 1 - position) : (first + position);
+      return (position >= 0 && n >= first && n < last) ? EXO_ICON_VIEW_NTH_ITEM (icon_view, n) : NULL;
+    }
+
+  /* otherwise items may span several columns, so lookup the item at the position */
+  for (lower = first, upper = last; lower < upper; )
+    {
+      mid = (lower + upper) / 2;
+      item = EXO_ICON_VIEW_NTH_ITEM (icon_view, mid);
+      n = (icon_view->priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS) ? item->col : item->row;
+      if (reversed ? (n > position) : (n < position))
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+
+  if (lower < last)
+    {
+      item = EXO_ICON_VIEW_NTH_ITEM (icon_view, lower);
+      n = (icon_view->priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS) ? item->col : item->row;
+      if (n == position)
+        return item;
+    }
+
+  return NULL;
+}
+
+
+
+static void
+exo_icon_view_get_line_items (const ExoIconView *icon_view,
+                              gint               start,
+                              gint               end,
+                              gint              *first_item,
+                              gint              *last_item)
+{
+  const ExoIconViewPrivate *priv = icon_view->priv;
+  const ExoIconViewLine    *lines = (const ExoIconViewLine *) priv->lines->data;
+  gint                      n_lines = priv->lines->len;
+  gint                      lower;
+  gint                      upper;
+  gint                      mid;
+
+  /* the line index is only valid once the layout is done */
+  if (G_UNLIKELY (priv->layout_idle_id != 0 || n_lines == 0))
+    {
+      *first_item = 0;
+      *last_item = EXO_ICON_VIEW_N_ITEMS (icon_view);
+      return;
+    }
+
+  /* lookup the first line that ends after start */
+  for (lower = 0, upper = n_lines; lower < upper; )
+    {
+      mid = (lower + upper) / 2;
+      if (lines[mid].end <= start)
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+
+  /* check if start is beyond the last line */
+  if (G_UNLIKELY (lower >= n_lines))
+    {
+      *first_item = *last_item = 0;
+      return;
+    }
+
+  /* collect all lines that begin before end */
+  for (upper = lower; upper < n_lines && lines[upper].start <= end; ++upper)
+    ;
+
+  *first_item = MIN (lines[lower].first, EXO_ICON_VIEW_N_ITEMS (icon_view));
+  *last_item = (upper < n_lines) ? lines[upper].first : EXO_ICON_VIEW_N_ITEMS (icon_view);
+  *last_item = MIN (*last_item, EXO_ICON_VIEW_N_ITEMS (icon_view));
+}
+
+
+
+static ExoIconViewItem*
+exo_icon_view_get_item_for_path (const ExoIconView *icon_view,
+                                 GtkTreePath       *path)
+{
+  gint idx;
+
+  /* paths are flat for the icon view, so the first index is all we need */
+  if (G_UNLIKELY (gtk_tree_path_get_depth (path) < 1))
+    return NULL;
+
+  idx = gtk_tree_path_get_indices (path)[0];
+  if (G_UNLIKELY (idx < 0 || idx >= EXO_ICON_VIEW_N_ITEMS (icon_view)))
+    return NULL;
+
+  return EXO_ICON_VIEW_NTH_ITEM (icon_view, idx);
+}
+
+
+
+static void
+exo_icon_view_update_item_indices (ExoIconView *icon_view,
+                                   gint         first)
+{
+  ExoIconViewItem *item;
+  gint             n;
+
+  /* renumber the items from first on, after they were shifted */
+  for (n = first; n < EXO_ICON_VIEW_N_ITEMS (icon_view); ++n)
+    {
+      item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, n);
+      if (G_LIKELY (item != NULL))
+        item->index = n;
+    }
+}
+
+
+
+static ExoIconViewItem*
+exo_icon_view_get_nth_item (const ExoIconView *icon_view,
+                            gint               item_index)
+{
+  ExoIconViewItem *item;
+
+  /* the items are logically part of the view, so the const getters
+   * may create the ones not materialized yet */
+  item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, item_index);
+  if (G_UNLIKELY (item == NULL))
+    item = exo_icon_view_materialize_item ((ExoIconView *) icon_view, item_index);
+
+  return item;
+}
+
+
+
+static ExoIconViewItem*
+exo_icon_view_materialize_item (ExoIconView *icon_view,
+                                gint         item_index)
+{
+  const ExoIconViewLine *line;
+  ExoIconViewPrivate    *priv = icon_view->priv;
+  ExoIconViewItem       *item;
+  gint                   focus_width;
+  gint                   n_line_items;
+  gint                   n_line;
+  gint                   n;
+
+  item = exo_icon_view_item_new (icon_view);
+  item->index = item_index;
+  item->area.width = -1;
+  gtk_tree_model_iter_nth_child (priv->model, &item->iter, NULL, item_index);
+  g_ptr_array_index (priv->items, item_index) = item;
+  priv->n_materialized += 1;
+
+  /* items placed by a fixed item size layout take their place from the lines */
+  if (G_LIKELY (priv->fixed_item_size && item_index < priv->layout_dirty_first && priv->lines->len > 0))
+    {
+      gtk_widget_style_get (GTK_WIDGET (icon_view),
+                            "focus-line-width", &focus_width,
+                            NULL);
+
+      n_line = exo_icon_view_find_line (icon_view, item_index);
+      line = &g_array_index (priv->lines, ExoIconViewLine, n_line);
+      n_line_items = ((n_line + 1 < (gint) priv->lines->len) ? line[1].first : EXO_ICON_VIEW_N_ITEMS (icon_view)) - line->first;
+      n = item_index - line->first;
+
+      /* same as exo_icon_view_layout_single_row() and _col() */
+      if (G_LIKELY (priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
+        {
+          item->area.width = priv->layout_item_size;
+          item->area.height = priv->fixed_item_height;
+          item->area.x = priv->margin + focus_width + n * (item->area.width + priv->column_spacing + 2 * focus_width);
+          item->area.y = line->start + focus_width;
+          item->row = n_line;
+          item->col = n;
+
+          if (G_UNLIKELY (priv->layout_direction == GTK_TEXT_DIR_RTL))
+            {
+              item->area.x = priv->layout_width - item->area.width - item->area.x;
+              item->col = n_line_items - 1 - n;
+            }
+        }
+      else
+        {
+          item->area.width = priv->fixed_item_width;
+          item->area.height = priv->layout_item_size;
+          item->area.x = line->start;
+          item->area.y = priv->margin + 2 * focus_width + n * (item->area.height + priv->row_spacing + 2 * focus_width);
+          item->row = n;
+          item->col = n_line;
+        }
+
+      item->needs_refine = TRUE;
+    }
+
+  return item;
+}
+
+
+
+static void
+exo_icon_view_release_items (ExoIconView *icon_view)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  ExoIconViewItem    *item;
+  GtkAdjustment      *adjustment;
+  gint                first_item;
+  gint                last_item;
+  gint                n_visible;
+  gint                start;
+  gint                end;
+  gint                n;
+
+  /* determine the items in the visible area */
+  adjustment = (priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS) ? priv->vadjustment : priv->hadjustment;
+  start = (gint) gtk_adjustment_get_value (adjustment);
+  end = start + (gint) gtk_adjustment_get_page_size (adjustment);
+  exo_icon_view_get_line_items (icon_view, start, end, &first_item, &last_item);
+
+  /* keep a page of items before and after the visible area for scrolling */
+  n_visible = last_item - first_item;
+  first_item = MAX (first_item - n_visible, 0);
+  last_item = MIN (last_item + n_visible, EXO_ICON_VIEW_N_ITEMS (icon_view));
+
+  for (n = 0; n < EXO_ICON_VIEW_N_ITEMS (icon_view); ++n)
+    {
+      /* skip the items around the visible area */
+      item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, n);
+      if (item == NULL || (n >= first_item && n < last_item))
+        continue;
+
+      /* keep the items referenced by the view or its accessible */
+      if (item == priv->cursor_item
+          || item == priv->anchor_item
+          || item == priv->edited_item
+          || item == priv->prelit_item
+          || item == priv->last_single_clicked
+          || EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item)
+          || exo_icon_view_accessible_has_item (icon_view, n))
+        continue;
+
+      g_ptr_array_index (priv->items, n) = NULL;
+      exo_icon_view_item_free (icon_view, item);
+    }
+
+  priv->n_materialized = 0;
+}
+
+
+
+static ExoIconViewItem*
+exo_icon_view_item_new (ExoIconView *icon_view)
+{
+  ExoIconViewArena *arena = &icon_view->priv->arena;
+  ExoIconViewItem  *item;
+
+  if (arena->free_records != NULL)
+    {
+      /* reuse the record of a released item */
+      item = arena->free_records;
+      arena->free_records = *((gpointer *) item);
+    }
+  else
+    {
+      if (G_UNLIKELY (arena->n_unused == 0))
+        {
+          /* the records have room for the cells known when the first block is allocated */
+          if (arena->blocks == NULL)
+            {
+              arena->n_cells = icon_view->priv->n_cells;
+              arena->record_size = sizeof (ExoIconViewItem) + arena->n_cells * (sizeof (GdkRectangle) + 2 * sizeof (gint));
+            }
+
+          arena->next_record = g_malloc (arena->record_size * EXO_ICON_VIEW_ARENA_BLOCK_SIZE);
+          arena->n_unused = EXO_ICON_VIEW_ARENA_BLOCK_SIZE;
+          arena->blocks = g_slist_prepend (arena->blocks, arena->next_record);
+        }
+
+      item = (ExoIconViewItem *) arena->next_record;
+      arena->next_record += arena->record_size;
+      arena->n_unused -= 1;
+    }
+
+  memset (item, 0, sizeof (*item));
+
+  return item;
+}
+
+
+
+static void
+exo_icon_view_item_free (ExoIconView     *icon_view,
+                         ExoIconViewItem *item)
+{
+  ExoIconViewArena *arena = &icon_view->priv->arena;
+
+  /* the record might be reused for another item */
+  if (G_UNLIKELY (icon_view->priv->cell_data_item == item))
+    icon_view->priv->cell_data_item = NULL;
+
+  exo_icon_view_item_free_geometry (arena, item);
+
+  /* keep the record for the next item */
+  *((gpointer *) item) = arena->free_records;
+  arena->free_records = item;
+}
+
+
+
+static void
+exo_icon_view_item_free_geometry (ExoIconViewArena *arena,
+                                  ExoIconViewItem  *item)
+{
+  /* the geometry is stored right behind the item, unless it didn't fit */
+  if (G_UNLIKELY (item->box != NULL && (gpointer) item->box != (gpointer) (item + 1)))
+    {
+      g_free (item->box);
+      arena->n_external -= 1;
+    }
+
+  item->box = NULL;
+}
+
+
+
+static void
+exo_icon_view_item_set_n_cells (ExoIconView     *icon_view,
+                                ExoIconViewItem *item)
+{
+  ExoIconViewArena *arena = &icon_view->priv->arena;
+  gchar            *buffer;
+  gsize             size;
+
+  /* release the previous geometry (if any) */
+  exo_icon_view_item_free_geometry (arena, item);
+
+  /* apply the new cell size */
+  item->n_cells = icon_view->priv->n_cells;
+  size = item->n_cells * (sizeof (GdkRectangle) + 2 * sizeof (gint));
+
+  /* use the record, unless cells were added after the arena was set up */
+  if (G_LIKELY (item->n_cells <= arena->n_cells))
+    {
+      buffer = memset (item + 1, 0, size);
+    }
+  else
+    {
+      buffer = g_malloc0 (size);
+      arena->n_external += 1;
+    }
+
+  /* assign the memory for box, after and before */
+  item->box = (GdkRectangle *) buffer;
+  item->after = (gint *) (buffer + item->n_cells * sizeof (GdkRectangle));
+  item->before = item->after + item->n_cells;
+}
+
+
+
+static void
+exo_icon_view_build_items (ExoIconView *icon_view)
+{
+  ExoIconViewItem *item;
+  GtkTreeIter      iter;
+  gint             n = 0;
+
+  /* with a fixed item size, the items are materialized when needed */
+  if (G_UNLIKELY (icon_view->priv->fixed_item_size))
+    {
+      g_ptr_array_set_size (icon_view->priv->items, gtk_tree_model_iter_n_children (icon_view->priv->model, NULL));
+      return;
+    }
+
+  /* allocate an item for every row of the model */
+  if (gtk_tree_model_get_iter_first (icon_view->priv->model, &iter))
+    {
+      do
+        {
+          item = exo_icon_view_item_new (icon_view);
+          item->iter = iter;
+          item->index = n++;
+          item->area.width = -1;
+          g_ptr_array_add (icon_view->priv->items, item);
+        }
+      while (gtk_tree_model_iter_next (icon_view->priv->model, &iter));
+    }
+}
+
+
+
+static void
+exo_icon_view_drop_items (ExoIconView *icon_view)
+{
+  ExoIconViewArena *arena = &icon_view->priv->arena;
+  ExoIconViewItem  *item;
+  GPtrArray        *items;
+  guint             n;
+
+  /* only the geometry that did not fit into the records is released one by one */
+  for (items = icon_view->priv->items; arena->n_external > 0 && items != NULL; )
+    {
+      for (n = 0; n < items->len; ++n)
+        {
+          item = EXO_ICON_VIEW_ITEM (g_ptr_array_index (items, n));
+          if (G_LIKELY (item != NULL))
+            exo_icon_view_item_free_geometry (arena, item);
+        }
+
+      items = (items != icon_view->priv->frozen_items) ? icon_view->priv->frozen_items : NULL;
+    }
+
+  g_ptr_array_set_size (icon_view->priv->items, 0);
+
+  /* drop the items replaced while frozen */
+  if (G_UNLIKELY (icon_view->priv->frozen_items != NULL))
+    {
+      g_ptr_array_free (icon_view->priv->frozen_items, TRUE);
+      icon_view->priv->frozen_items = NULL;
+    }
+
+  if (G_UNLIKELY (icon_view->priv->frozen_snapshot != NULL))
+    {
+      cairo_surface_destroy (icon_view->priv->frozen_snapshot);
+      icon_view->priv->frozen_snapshot = NULL;
+    }
+
+  /* release all items at once */
+  g_slist_free_full (arena->blocks, g_free);
+  memset (arena, 0, sizeof (*arena));
+  icon_view->priv->cell_data_item = NULL;
+  exo_icon_view_drop_size_caches (icon_view);
+  exo_icon_view_search_index_drop (icon_view);
+  exo_icon_view_search_slice_cancel (icon_view);
+}
+
+
+
+static void
+exo_icon_view_forget_items (ExoIconView *icon_view)
+{
+  /* forget everything that points to the previous items */
+  g_array_set_size (icon_view->priv->lines, 0);
+  icon_view->priv->anchor_item = NULL;
+  icon_view->priv->cursor_item = NULL;
+  icon_view->priv->prelit_item = NULL;
+  icon_view->priv->last_single_clicked = NULL;
+  icon_view->priv->n_materialized = 0;
+
+  /* cancel any pending single click timer */
+  if (G_UNLIKELY (icon_view->priv->single_click_timeout_id != 0))
+    g_source_remove (icon_view->priv->single_click_timeout_id);
+
+  /* reset cursor when in single click mode and realized */
+  if (G_UNLIKELY (icon_view->priv->single_click && gtk_widget_get_realized (GTK_WIDGET (icon_view))))
+    gdk_window_set_cursor (icon_view->priv->bin_window, NULL);
+}
+
+
+
+static void
+exo_icon_view_reset_items (ExoIconView *icon_view)
+{
+  /* forget everything that refers to the previous items */
+  exo_icon_view_forget_items (icon_view);
+  exo_icon_view_selection_reset (&icon_view->priv->selection, FALSE);
+  exo_icon_view_selection_reset (&icon_view->priv->rubberband_selection, FALSE);
+  icon_view->priv->width = 0;
+  icon_view->priv->height = 0;
+}
+
+
+
+/* changed_row and delta describe a row inserted (delta 1) or deleted
+ * (delta -1), new_order a reordering, which the model already applied
+ * and the selection already followed
+ */
+static void
+exo_icon_view_freeze_items (ExoIconView *icon_view,
+                            gint         changed_row,
+                            gint         delta,
+                            const gint  *new_order)
+{
+  /* the model is ignored until thawed */
+  exo_icon_view_search_index_drop (icon_view);
+
+  /* the items are replaced only once per freeze */
+  if (G_LIKELY (icon_view->priv->frozen_items != NULL))
+    return;
+
+  exo_icon_view_stop_editing (icon_view, TRUE);
+
+  /* the selection is kept by position, and so are the cursor and the
+   * anchor, which follow the model changes until thawed
+   */
+  icon_view->priv->frozen_cursor = (icon_view->priv->cursor_item != NULL) ? icon_view->priv->cursor_item->index : -1;
+  icon_view->priv->frozen_anchor = (icon_view->priv->anchor_item != NULL) ? icon_view->priv->anchor_item->index : -1;
+
+  /* keep the visible items on screen until thawed */
+  exo_icon_view_snapshot_items (icon_view, changed_row, delta, new_order);
+
+  /* set the previous items aside until thawed, and ignore the model
+   * until then, so every change is recorded in O(1)
+   */
+  icon_view->priv->frozen_items = icon_view->priv->items;
+  icon_view->priv->items = g_ptr_array_new ();
+  exo_icon_view_drop_size_caches (icon_view);
+  exo_icon_view_forget_items (icon_view);
+
+  /* the item accessibles must not follow the model changes with
+   * the previous items, the accessible has no children until thawed
+   */
+  exo_icon_view_accessible_items_rebuilt (icon_view);
+}
+
+
+
+static void
+exo_icon_view_snapshot_items (ExoIconView *icon_view,
+                              gint         changed_row,
+                              gint         delta,
+                              const gint  *new_order)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  ExoIconViewItem    *item;
+  GtkStyleContext    *context;
+  GdkRectangle        visible;
+  cairo_t            *cr;
+  gint               *rows;
+  gint                first_item;
+  gint                last_item;
+  gint                row;
+  gint                n;
+
+  /* only a view that was drawn already has something to repeat */
+  if (!gtk_widget_is_drawable (GTK_WIDGET (icon_view)) || priv->model == NULL
+      || priv->layout_idle_id != 0 || priv->lines->len == 0)
+    return;
+
+  visible.x = gtk_adjustment_get_value (priv->hadjustment);
+  visible.y = gtk_adjustment_get_value (priv->vadjustment);
+  visible.width = gtk_adjustment_get_page_size (priv->hadjustment);
+  visible.height = gtk_adjustment_get_page_size (priv->vadjustment);
+  if (G_UNLIKELY (visible.width <= 0 || visible.height <= 0))
+    return;
+
+  priv->frozen_snapshot = gdk_window_create_similar_surface (priv->bin_window, CAIRO_CONTENT_COLOR_ALPHA,
+                                                             visible.width, visible.height);
+  priv->frozen_snapshot_x = visible.x;
+  priv->frozen_snapshot_y = visible.y;
+
+  if (G_LIKELY (priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
+    exo_icon_view_get_line_items (icon_view, visible.y, visible.y + visible.height, &first_item, &last_item);
+  else
+    exo_icon_view_get_line_items (icon_view, visible.x, visible.x + visible.width, &first_item, &last_item);
+
+  /* determine the rows of the visible items in the changed model,
+   * new_order[i] is the former position of the row now at i
+   */
+  rows = g_new (gint, last_item - first_item + 1);
+  for (n = first_item; n < last_item; ++n)
+    {
+      if (G_UNLIKELY (new_order != NULL))
+        rows[n - first_item] = -1;
+      else if (n < changed_row)
+        rows[n - first_item] = n;
+      else if (delta > 0)
+        rows[n - first_item] = n + 1;
+      else
+        rows[n - first_item] = (n > changed_row) ? n - 1 : -1;
+    }
+  if (G_UNLIKELY (new_order != NULL))
+    {
+      for (row = 0; row < EXO_ICON_VIEW_N_ITEMS (icon_view); ++row)
+        if (new_order[row] >= first_item && new_order[row] < last_item)
+          rows[new_order[row] - first_item] = row;
+    }
+
+  /* paint the visible items like exo_icon_view_draw(), but with the
+   * data of their rows now, the items are set aside afterwards anyway
+   */
+  cr = cairo_create (priv->frozen_snapshot);
+  cairo_translate (cr, -visible.x, -visible.y);
+  context = gtk_widget_get_style_context (GTK_WIDGET (icon_view));
+  gtk_style_context_save (context);
+  gtk_style_context_add_class (context, GTK_STYLE_CLASS_CELL);
+  for (n = first_item; n < last_item; ++n)
+    {
+      /* a deleted row is not drawn again */
+      row = rows[n - first_item];
+      if (G_UNLIKELY (row < 0))
+        continue;
+
+      item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
+      if (!gdk_rectangle_intersect (&item->area, &visible, NULL))
+        continue;
+
+      item->index = row;
+      gtk_tree_model_iter_nth_child (priv->model, &item->iter, NULL, row);
+      priv->cell_data_item = NULL;
+      exo_icon_view_paint_item (icon_view, item, cr, item->area.x, item->area.y, TRUE);
+    }
+  gtk_style_context_restore (context);
+  cairo_destroy (cr);
+  g_free (rows);
+
+  priv->cell_data_item = NULL;
+}
+
+
+
+static ExoIconViewItem*
+exo_icon_view_get_item_at_coords (const ExoIconView    *icon_view,
+                                  gint                  x,
+                                  gint                  y,
+                                  gboolean              only_in_cell,
+                                  ExoIconViewCellInfo **cell_at_pos)
+{
+  const ExoIconViewPrivate *priv = icon_view->priv;
+  ExoIconViewCellInfo      *info;
+  ExoIconViewItem          *item;
+  GdkRectangle              box;
+  const GList              *lp;
+  gint                      first_item;
+  gint                      last_item;
+  gint                      spacing;
+  gint                      n;
+
+  /* only the lines near the position can contain the item */
+  spacing = MAX (priv->row_spacing, priv->column_spacing);
+  if (G_LIKELY (priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
+    exo_icon_view_get_line_items (icon_view, y - spacing, y + spacing, &first_item, &last_item);
+  else
+    exo_icon_view_get_line_items (icon_view, x - spacing, x + spacing, &first_item, &last_item);
+
+  for (n = first_item; n < last_item; ++n)
+    {
+      item = EXO_ICON_VIEW_NTH_ITEM (icon_view, n);
+      if (x >= item->area.x - priv->row_spacing / 2 && x <= item->area.x + item->area.width + priv->row_spacing / 2 &&
+          y >= item->area.y - priv->column_spacing / 2 && y <= item->area.y + item->area.height + priv->column_spacing / 2)
+        {
+          if (only_in_cell || cell_at_pos)
+            {
+              exo_icon_view_refine_item ((ExoIconView *) icon_view, item);
+              exo_icon_view_set_cell_data (icon_view, item);
+              for (lp = priv->cell_list; lp != NULL; lp = lp->next)
+                {
+                  /* check if the cell is visible */
+                  info = (ExoIconViewCellInfo *) lp->data;
+                  if (!gtk_cell_renderer_get_visible (info->cell))
+                    continue;
+
+                  box = item->box[info->position];
+                  if ((x >= box.x && x <= box.x + box.width &&
+                       y >= box.y && y <= box.y + box.height))
+                    {
+                      if (cell_at_pos != NULL)
+                        *cell_at_pos = info;
+
+                      return item;
+                    }
+                }
+
+              if (only_in_cell)
+                return NULL;
+
+              if (cell_at_pos != NULL)
+                *cell_at_pos = NULL;
+            }
+
+          return item;
+        }
+    }
+
+  return NULL;
+}
+
+
+
+static guint
+exo_icon_view_selection_find (const ExoIconViewSelection *selection,
+                              gint                        item_index)
+{
+  guint lower = 0;
+  guint upper = selection->ranges->len;
+  guint middle;
+
+  /* binary search for the first range ending after item_index */
+  while (lower < upper)
+    {
+      middle = (lower + upper) / 2;
+      if (g_array_index (selection->ranges, ExoIconViewRange, middle).end <= item_index)
+        lower = middle + 1;
+      else
+        upper = middle;
+    }
+
+  return lower;
+}
+
+
+
+static void
+exo_icon_view_selection_add_range (ExoIconViewSelection *selection,
+                                   gint                  start,
+                                   gint                  end)
+{
+  ExoIconViewRange *range;
+  ExoIconViewRange  merged;
+  guint             first;
+  guint             last;
+
+  /* determine the ranges that overlap or touch [start, end) */
+  first = exo_icon_view_selection_find (selection, start - 1);
+  for (last = first; last < selection->ranges->len; ++last)
+    if (g_array_index (selection->ranges, ExoIconViewRange, last).start > end)
+      break;
+
+  if (first == last)
+    {
+      merged.start = start;
+      merged.end = end;
+      g_array_insert_val (selection->ranges, first, merged);
+    }
+  else
+    {
+      /* merge them into the first one */
+      range = &g_array_index (selection->ranges, ExoIconViewRange, first);
+      range->start = MIN (range->start, start);
+      range->end = MAX (g_array_index (selection->ranges, ExoIconViewRange, last - 1).end, end);
+      if (last - first > 1)
+        g_array_remove_range (selection->ranges, first + 1, last - first - 1);
+    }
+}
+
+
+
+static void
+exo_icon_view_selection_remove_range (ExoIconViewSelection *selection,
+                                      gint                  start,
+                                      gint                  end)
+{
+  ExoIconViewRange  keep[2];
+  ExoIconViewRange *range;
+  guint             n_keep = 0;
+  guint             first;
+  guint             last;
+
+  /* determine the ranges that overlap [start, end) */
+  first = exo_icon_view_selection_find (selection, start);
+  for (last = first; last < selection->ranges->len; ++last)
+    if (g_array_index (selection->ranges, ExoIconViewRange, last).start >= end)
+      break;
+
+  if (G_UNLIKELY (first == last))
+    return;
+
+  /* keep the parts outside of [start, end) */
+  range = &g_array_index (selection->ranges, ExoIconViewRange, first);
+  if (range->start < start)
+    {
+      keep[n_keep].start = range->start;
+      keep[n_keep++].end = start;
+    }
+  range = &g_array_index (selection->ranges, ExoIconViewRange, last - 1);
+  if (range->end > end)
+    {
+      keep[n_keep].start = end;
+      keep[n_keep++].end = range->end;
+    }
+
+  g_array_remove_range (selection->ranges, first, last - first);
+  if (n_keep > 0)
+    g_array_insert_vals (selection->ranges, first, keep, n_keep);
+}
+
+
+
+static gboolean
+exo_icon_view_selection_contains (const ExoIconViewSelection *selection,
+                                  gint                        item_index)
+{
+  gboolean found;
+  guint    n;
+
+  n = exo_icon_view_selection_find (selection, item_index);
+  found = (n < selection->ranges->len && g_array_index (selection->ranges, ExoIconViewRange, n).start <= item_index);
+
+  return found ^ selection->inverted;
+}
+
+
+
+static gboolean
+exo_icon_view_selection_contains_range (const ExoIconViewSelection *selection,
+                                        gint                        start,
+                                        gint                        end)
+{
+  const ExoIconViewRange *range;
+  guint                   n;
+
+  n = exo_icon_view_selection_find (selection, start);
+  range = (n < selection->ranges->len) ? &g_array_index (selection->ranges, ExoIconViewRange, n) : NULL;
+
+  /* either a range covers all items, or no range of unselected items overlaps */
+  if (!selection->inverted)
+    return (range != NULL && range->start <= start && range->end >= end);
+  else
+    return (range == NULL || range->start >= end);
+}
+
+
 
-      gtk_cell_renderer_render (info->cell,
-                                cr,
-                                GTK_WIDGET (icon_view),
-                                &cell_area, &cell_area, flags);
+static void
+exo_icon_view_selection_select_range (ExoIconViewSelection *selection,
+                                      gint                  start,
+                                      gint                  end)
+{
+  if (G_LIKELY (!selection->inverted))
+    exo_icon_view_selection_add_range (selection, start, end);
+  else
+    exo_icon_view_selection_remove_range (selection, start, end);
+}
 
-      cairo_restore (cr);
-    }
 
-  gtk_style_context_restore (style_context);
+
+static void
+exo_icon_view_selection_unselect_range (ExoIconViewSelection *selection,
+                                        gint                  start,
+                                        gint                  end)
+{
+  if (G_LIKELY (!selection->inverted))
+    exo_icon_view_selection_remove_range (selection, start, end);
+  else
+    exo_icon_view_selection_add_range (selection, start, end);
 }
 
 
 
 static void
-exo_icon_view_queue_draw_item (ExoIconView     *icon_view,
-                               ExoIconViewItem *item)
+exo_icon_view_selection_reset (ExoIconViewSelection *selection,
+                               gboolean              all_selected)
 {
-  GdkRectangle rect;
-  gint         focus_width;
+  /* no ranges select nothing, or everything if inverted */
+  g_array_set_size (selection->ranges, 0);
+  selection->inverted = all_selected;
+}
 
-  gtk_widget_style_get (GTK_WIDGET (icon_view),
-                        "focus-line-width", &focus_width,
-                        NULL);
 
-  rect.x = item->area.x - focus_width;
-  rect.y = item->area.y - focus_width;
-  rect.width = item->area.width + 2 * focus_width;
-  rect.height = item->area.height + 2 * focus_width;
 
-  if (icon_view->priv->bin_window)
-    gdk_window_invalidate_rect (icon_view->priv->bin_window, &rect, TRUE);
+static void
+exo_icon_view_selection_copy (ExoIconViewSelection       *dest,
+                              const ExoIconViewSelection *source)
+{
+  g_array_set_size (dest->ranges, 0);
+  g_array_append_vals (dest->ranges, source->ranges->data, source->ranges->len);
+  dest->inverted = source->inverted;
 }
 
 
 
 static gboolean
-layout_callback (gpointer user_data)
+exo_icon_view_selection_next_range (const ExoIconViewSelection *selection,
+                                    gint                        n_items,
+                                    gint                        from,
+                                    gint                       *start_return,
+                                    gint                       *end_return)
 {
-  ExoIconView *icon_view = EXO_ICON_VIEW (user_data);
+  const ExoIconViewRange *range;
+  guint                   n;
 
-  exo_icon_view_layout (icon_view);
+  n = exo_icon_view_selection_find (selection, from);
+  range = (n < selection->ranges->len) ? &g_array_index (selection->ranges, ExoIconViewRange, n) : NULL;
 
-  return FALSE;
+  if (G_LIKELY (!selection->inverted))
+    {
+      if (range == NULL)
+        return FALSE;
+
+      *start_return = MAX (range->start, from);
+      *end_return = range->end;
+    }
+  else
+    {
+      /* the selected items are the gaps between the ranges */
+      if (range != NULL && range->start <= from)
+        {
+          from = range->end;
+          range = (n + 1 < selection->ranges->len) ? range + 1 : NULL;
+        }
+
+      *start_return = from;
+      *end_return = (range != NULL) ? range->start : n_items;
+    }
+
+  return (*start_return < MIN (*end_return, n_items));
 }
 
 
 
-static void
-layout_destroy (gpointer user_data)
+static gint
+exo_icon_view_selection_count (const ExoIconViewSelection *selection,
+                               gint                        n_items)
 {
-  EXO_ICON_VIEW (user_data)->priv->layout_idle_id = 0;
+  gint  count = 0;
+  guint n;
+
+  for (n = 0; n < selection->ranges->len; ++n)
+    count += g_array_index (selection->ranges, ExoIconViewRange, n).end - g_array_index (selection->ranges, ExoIconViewRange, n).start;
+
+  return selection->inverted ? (n_items - count) : count;
 }
 
 
 
-static void
-exo_icon_view_queue_layout (ExoIconView *icon_view)
+static gint
+exo_icon_view_selection_nth (const ExoIconViewSelection *selection,
+                             gint                        n_items,
+                             gint                        nth)
 {
-  if (G_UNLIKELY (icon_view->priv->layout_idle_id == 0))
-    icon_view->priv->layout_idle_id = gdk_threads_add_idle_full (G_PRIORITY_DEFAULT_IDLE, layout_callback, icon_view, layout_destroy);
+  gint start;
+  gint end;
+  gint n;
+
+  /* skip whole ranges until we reach the nth selected item */
+  for (n = 0; nth >= 0 && exo_icon_view_selection_next_range (selection, n_items, n, &start, &end); n = end)
+    {
+      if (nth < end - start)
+        return start + nth;
+      nth -= end - start;
+    }
+
+  return -1;
 }
 
 
 
 static void
-exo_icon_view_set_cursor_item (ExoIconView     *icon_view,
-                               ExoIconViewItem *item,
-                               gint             cursor_cell)
+exo_icon_view_selection_insert (ExoIconViewSelection *selection,
+                                gint                  item_index)
 {
-  if (icon_view->priv->cursor_item == item &&
-      (cursor_cell < 0 || cursor_cell == icon_view->priv->cursor_cell))
-    return;
+  ExoIconViewRange *range;
+  ExoIconViewRange  tail;
+  guint             n;
 
-  if (icon_view->priv->cursor_item != NULL)
-    exo_icon_view_queue_draw_item (icon_view, icon_view->priv->cursor_item);
+  /* split the range containing the new item */
+  n = exo_icon_view_selection_find (selection, item_index);
+  if (n < selection->ranges->len && g_array_index (selection->ranges, ExoIconViewRange, n).start < item_index)
+    {
+      range = &g_array_index (selection->ranges, ExoIconViewRange, n);
+      tail.start = item_index;
+      tail.end = range->end;
+      range->end = item_index;
+      g_array_insert_val (selection->ranges, ++n, tail);
+    }
 
-  icon_view->priv->cursor_item = item;
-  if (cursor_cell >= 0)
-    icon_view->priv->cursor_cell = cursor_cell;
+  /* move the following ranges behind the new item */
+  for (; n < selection->ranges->len; ++n)
+    {
+      range = &g_array_index (selection->ranges, ExoIconViewRange, n);
+      range->start += 1;
+      range->end += 1;
+    }
 
-  exo_icon_view_queue_draw_item (icon_view, item);
+  /* new items are not selected */
+  if (G_UNLIKELY (selection->inverted))
+    exo_icon_view_selection_add_range (selection, item_index, item_index + 1);
 }
 
 
 
-static ExoIconViewItem*
-exo_icon_view_get_item_at_coords (const ExoIconView    *icon_view,
-                                  gint                  x,
-                                  gint                  y,
-                                  gboolean              only_in_cell,
-                                  ExoIconViewCellInfo **cell_at_pos)
+static void
+exo_icon_view_selection_delete (ExoIconViewSelection *selection,
+                                gint                  item_index)
 {
-  const ExoIconViewPrivate *priv = icon_view->priv;
-  ExoIconViewCellInfo      *info;
-  ExoIconViewItem          *item;
-  GdkRectangle              box;
-  const GList              *items;
-  const GList              *lp;
+  ExoIconViewRange *range;
+  guint             first;
+  guint             n;
+
+  exo_icon_view_selection_remove_range (selection, item_index, item_index + 1);
 
-  for (items = priv->items; items != NULL; items = items->next)
+  /* move the following ranges to close the gap */
+  first = exo_icon_view_selection_find (selection, item_index);
+  for (n = first; n < selection->ranges->len; ++n)
     {
-      item = items->data;
-      if (x >= item->area.x - priv->row_spacing / 2 && x <= item->area.x + item->area.width + priv->row_spacing / 2 &&
-          y >= item->area.y - priv->column_spacing / 2 && y <= item->area.y + item->area.height + priv->column_spacing / 2)
+      range = &g_array_index (selection->ranges, ExoIconViewRange, n);
+      range->start -= 1;
+      range->end -= 1;
+    }
+
+  /* merge the ranges around the gap if they touch now */
+  if (first > 0 && first < selection->ranges->len)
+    {
+      range = &g_array_index (selection->ranges, ExoIconViewRange, first - 1);
+      if (range->end == g_array_index (selection->ranges, ExoIconViewRange, first).start)
         {
-          if (only_in_cell || cell_at_pos)
-            {
-              exo_icon_view_set_cell_data (icon_view, item);
-              for (lp = priv->cell_list; lp != NULL; lp = lp->next)
-                {
-                  /* check if the cell is visible */
-                  info = (ExoIconViewCellInfo *) lp->data;
-                  if (!gtk_cell_renderer_get_visible (info->cell))
-                    continue;
+          range->end = g_array_index (selection->ranges, ExoIconViewRange, first).end;
+          g_array_remove_index (selection->ranges, first);
+        }
+    }
+}
 
-                  box = item->box[info->position];
-                  if ((x >= box.x && x <= box.x + box.width &&
-                       y >= box.y && y <= box.y + box.height))
-                    {
-                      if (cell_at_pos != NULL)
-                        *cell_at_pos = info;
 
-                      return item;
-                    }
-                }
 
-              if (only_in_cell)
-                return NULL;
+static void
+exo_icon_view_selection_reorder (ExoIconViewSelection *selection,
+                                 gint                  n_items,
+                                 const gint           *new_order)
+{
+  ExoIconViewRange *range = NULL;
+  ExoIconViewRange  single;
+  GArray           *ranges;
+  gint              n;
 
-              if (cell_at_pos != NULL)
-                *cell_at_pos = NULL;
-            }
+  /* new_order[n] is the former position of the item now at position n */
+  ranges = g_array_new (FALSE, FALSE, sizeof (ExoIconViewRange));
+  for (n = 0; n < n_items; ++n)
+    {
+      if (!(exo_icon_view_selection_contains (selection, new_order[n]) ^ selection->inverted))
+        continue;
 
-          return item;
+      if (range != NULL && range->end == n)
+        {
+          range->end = n + 1;
+        }
+      else
+        {
+          single.start = n;
+          single.end = n + 1;
+          g_array_append_val (ranges, single);
+          range = &g_array_index (ranges, ExoIconViewRange, ranges->len - 1);
         }
     }
 
-  return NULL;
+  g_array_free (selection->ranges, TRUE);
+  selection->ranges = ranges;
+}
+
+
+
+static void
+exo_icon_view_set_item_selected (ExoIconView     *icon_view,
+                                 ExoIconViewItem *item,
+                                 gboolean         selected)
+{
+  if (selected)
+    exo_icon_view_selection_select_range (&icon_view->priv->selection, item->index, item->index + 1);
+  else
+    exo_icon_view_selection_unselect_range (&icon_view->priv->selection, item->index, item->index + 1);
 }
 
 
@@ -3947,16 +6541,16 @@ static void
 exo_icon_view_select_item (ExoIconView      *icon_view,
                            ExoIconViewItem  *item)
 {
-  if (item->selected || icon_view->priv->selection_mode == GTK_SELECTION_NONE)
+  if (EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item) || icon_view->priv->selection_mode == GTK_SELECTION_NONE)
     return;
   else if (icon_view->priv->selection_mode != GTK_SELECTION_MULTIPLE)
     exo_icon_view_unselect_all_internal (icon_view);
 
-  item->selected = TRUE;
+  exo_icon_view_set_item_selected (icon_view, item, TRUE);
 
   exo_icon_view_queue_draw_item (icon_view, item);
 
-  g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+  exo_icon_view_queue_selection_changed (icon_view);
 }
 
 
@@ -3965,16 +6559,16 @@ static void
 exo_icon_view_unselect_item (ExoIconView      *icon_view,
                              ExoIconViewItem  *item)
 {
-  if (!item->selected)
+  if (!EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item))
     return;
 
   if (icon_view->priv->selection_mode == GTK_SELECTION_NONE ||
       icon_view->priv->selection_mode == GTK_SELECTION_BROWSE)
     return;
 
-  item->selected = FALSE;
+  exo_icon_view_set_item_selected (icon_view, item, FALSE);
 
-  g_signal_emit (G_OBJECT (icon_view), icon_view_signals[SELECTION_CHANGED], 0);
+  exo_icon_view_queue_selection_changed (icon_view);
 
   exo_icon_view_queue_draw_item (icon_view, item);
 }
@@ -3988,22 +6582,88 @@ exo_icon_view_row_changed (GtkTreeModel *model,
                            ExoIconView  *icon_view)
 {
   ExoIconViewItem *item;
+  GdkRectangle     area;
+  GdkRectangle    *box;
+  gint             n;
+
+  /* the items are rebuilt on thaw anyway */
+  if (G_UNLIKELY (icon_view->priv->frozen_items != NULL))
+    {
+      exo_icon_view_search_index_drop (icon_view);
+      return;
+    }
+
+  /* the attributes must be read again from the model */
+  icon_view->priv->cell_data_item = NULL;
+
+  /* the sizes measured with other cell configurations are outdated */
+  n = gtk_tree_path_get_indices (path)[0];
+  exo_icon_view_size_caches_forget (icon_view, n);
+  exo_icon_view_search_index_changed (icon_view, iter, n);
+
+  /* an item that was not materialized yet has nothing to update */
+  if (G_UNLIKELY (EXO_ICON_VIEW_PEEK_ITEM (icon_view, n) == NULL))
+    {
+      if (G_UNLIKELY (exo_icon_view_selection_contains (&icon_view->priv->selection, n)))
+        exo_icon_view_queue_selection_changed (icon_view);
+      return;
+    }
 
-  item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices(path)[0]);
+  item = exo_icon_view_get_item_for_path (icon_view, path);
 
   /* stop editing this item */
   if (G_UNLIKELY (item == icon_view->priv->edited_item))
     exo_icon_view_stop_editing (icon_view, TRUE);
 
   /* emit "selection-changed" if the item is selected */
-  if (G_UNLIKELY (item->selected))
-    g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+  if (G_UNLIKELY (EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item)))
+    exo_icon_view_queue_selection_changed (icon_view);
 
-  /* recalculate layout (a value of -1 for width
-   * indicates that the item needs to be layouted).
-   */
-  item->area.width = -1;
-  exo_icon_view_queue_layout (icon_view);
+  /* with a fixed item size, the item keeps its place and only its cells are measured again */
+  if (G_UNLIKELY (icon_view->priv->fixed_item_size && item->area.width != -1))
+    {
+      item->needs_refine = TRUE;
+      exo_icon_view_queue_draw_item (icon_view, item);
+      return;
+    }
+
+  /* check if the item was already measured before */
+  if (G_LIKELY (item->area.width != -1 && item->n_cells == icon_view->priv->n_cells))
+    {
+      /* remember the current geometry */
+      area = item->area;
+      box = g_newa (GdkRectangle, item->n_cells);
+      memcpy (box, item->box, item->n_cells * sizeof (GdkRectangle));
+
+      /* measure the item again */
+      item->area.width = -1;
+      exo_icon_view_calculate_item_size (icon_view, item);
+
+      for (n = 0; n < item->n_cells; ++n)
+        if (box[n].width != item->box[n].width || box[n].height != item->box[n].height)
+          break;
+
+      /* if the size didn't change, the item keeps its place and only needs to be redrawn */
+      if (G_LIKELY (n == item->n_cells))
+        {
+          item->area = area;
+          exo_icon_view_queue_draw_item (icon_view, item);
+          return;
+        }
+
+      exo_icon_view_release_item_size (icon_view, &area);
+    }
+  else
+    {
+      /* recalculate layout (a value of -1 for width
+       * indicates that the item needs to be layouted).
+       */
+      exo_icon_view_release_item_size (icon_view, &item->area);
+      item->area.width = -1;
+    }
+
+  /* layout the item (and the ones it might push around) */
+  exo_icon_view_queue_layout_from (icon_view, item->index, item->index);
 }
 
 
@@ -4019,14 +6679,49 @@ exo_icon_view_row_inserted (GtkTreeModel *model,
 
   idx = gtk_tree_path_get_indices (path)[0];
 
-  /* allocate the new item */
-  item = g_slice_new0 (ExoIconViewItem);
-  item->iter = *iter;
-  item->area.width = -1;
-  icon_view->priv->items = g_list_insert (icon_view->priv->items, item, idx);
+  /* while frozen, the items are rebuilt on thaw, and only the positions
+   * that must survive the rebuild move along
+   */
+  if (G_UNLIKELY (icon_view->priv->freeze_count > 0))
+    {
+      exo_icon_view_selection_insert (&icon_view->priv->selection, idx);
+      if (G_UNLIKELY (icon_view->priv->doing_rubberband))
+        exo_icon_view_selection_insert (&icon_view->priv->rubberband_selection, idx);
+      exo_icon_view_freeze_items (icon_view, idx, 1, NULL);
+      if (icon_view->priv->frozen_cursor >= idx)
+        icon_view->priv->frozen_cursor += 1;
+      if (icon_view->priv->frozen_anchor >= idx)
+        icon_view->priv->frozen_anchor += 1;
+      return;
+    }
 
-  /* recalculate the layout */
-  exo_icon_view_queue_layout (icon_view);
+  /* allocate the new item, unless it's materialized when needed */
+  if (G_UNLIKELY (icon_view->priv->fixed_item_size))
+    {
+      item = NULL;
+    }
+  else
+    {
+      item = exo_icon_view_item_new (icon_view);
+      item->iter = *iter;
+      item->area.width = -1;
+    }
+  g_ptr_array_insert (icon_view->priv->items, idx, item);
+  exo_icon_view_size_caches_insert (icon_view, idx);
+  exo_icon_view_search_index_insert (icon_view, iter, idx);
+
+  /* a running search must start over */
+  if (G_UNLIKELY (icon_view->priv->search_slice_id != 0))
+    icon_view->priv->search_slice_row = icon_view->priv->search_slice_count = 0;
+
+  /* the item and all following items have new indices */
+  exo_icon_view_update_item_indices (icon_view, idx);
+  exo_icon_view_selection_insert (&icon_view->priv->selection, idx);
+  if (G_UNLIKELY (icon_view->priv->doing_rubberband))
+    exo_icon_view_selection_insert (&icon_view->priv->rubberband_selection, idx);
+
+  /* recalculate the layout, starting with the new item */
+  exo_icon_view_queue_layout_from (icon_view, idx, G_MAXINT);
 }
 
 
@@ -4037,25 +6732,44 @@ exo_icon_view_row_deleted (GtkTreeModel *model,
                            ExoIconView  *icon_view)
 {
   ExoIconViewItem *item;
+  ExoIconViewItem *sibling;
   gboolean         changed = FALSE;
-  GList           *list;
+  gint             idx;
 
-  /* determine the position and the item for the path */
-  list = g_list_nth (icon_view->priv->items, gtk_tree_path_get_indices (path)[0]);
-  item = list->data;
+  idx = gtk_tree_path_get_indices (path)[0];
 
-  if (G_UNLIKELY (item == icon_view->priv->edited_item))
-    exo_icon_view_stop_editing (icon_view, TRUE);
+  /* check if the selection changed */
+  if (G_UNLIKELY (exo_icon_view_selection_contains (&icon_view->priv->selection, idx)))
+    changed = TRUE;
+
+  /* while frozen, the items are rebuilt on thaw, and only the positions
+   * that must survive the rebuild move along (the cursor and the anchor
+   * of a deleted row move to the next row, or the last one on thaw)
+   */
+  if (G_UNLIKELY (icon_view->priv->freeze_count > 0))
+    {
+      exo_icon_view_selection_delete (&icon_view->priv->selection, idx);
+      if (G_UNLIKELY (icon_view->priv->doing_rubberband))
+        exo_icon_view_selection_delete (&icon_view->priv->rubberband_selection, idx);
+      exo_icon_view_freeze_items (icon_view, idx, -1, NULL);
+      if (icon_view->priv->frozen_cursor > idx)
+        icon_view->priv->frozen_cursor -= 1;
+      if (icon_view->priv->frozen_anchor > idx)
+        icon_view->priv->frozen_anchor -= 1;
+      if (G_UNLIKELY (changed))
+        exo_icon_view_queue_selection_changed (icon_view);
+      return;
+    }
 
-  /* use the next item (if any) as anchor, else use prev, otherwise reset anchor */
-  if (G_UNLIKELY (item == icon_view->priv->anchor_item))
-    icon_view->priv->anchor_item = (list->next != NULL) ? list->next->data : ((list->prev != NULL) ? list->prev->data : NULL);
+  /* determine the item for the path (an item that was never
+   * materialized cannot be referenced anywhere)
+   */
+  item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, idx);
 
-  /* use the next item (if any) as cursor, else use prev, otherwise reset cursor */
-  if (G_UNLIKELY (item == icon_view->priv->cursor_item))
-    icon_view->priv->cursor_item = (list->next != NULL) ? list->next->data : ((list->prev != NULL) ? list->prev->data : NULL);
+  if (G_UNLIKELY (item != NULL && item == icon_view->priv->edited_item))
+    exo_icon_view_stop_editing (icon_view, TRUE);
 
-  if (G_UNLIKELY (item == icon_view->priv->prelit_item))
+  if (G_UNLIKELY (item != NULL && item == icon_view->priv->prelit_item))
     {
       /* reset the prelit item */
       icon_view->priv->prelit_item = NULL;
@@ -4069,27 +6783,56 @@ exo_icon_view_row_deleted (GtkTreeModel *model,
         gdk_window_set_cursor (icon_view->priv->bin_window, NULL);
     }
 
-  /* check if the selection changed */
-  if (G_UNLIKELY (item->selected))
-    changed = TRUE;
+  /* drop the item from the array and renumber the following items */
+  g_ptr_array_remove_index (icon_view->priv->items, idx);
+  exo_icon_view_size_caches_delete (icon_view, idx);
+  exo_icon_view_search_index_delete (icon_view, idx);
+
+  /* a running search must start over */
+  if (G_UNLIKELY (icon_view->priv->search_slice_id != 0))
+    icon_view->priv->search_slice_row = icon_view->priv->search_slice_count = 0;
 
-  /* release the item resources */
-  g_free (item->box);
+  exo_icon_view_update_item_indices (icon_view, idx);
+  exo_icon_view_selection_delete (&icon_view->priv->selection, idx);
+  if (G_UNLIKELY (icon_view->priv->doing_rubberband))
+    exo_icon_view_selection_delete (&icon_view->priv->rubberband_selection, idx);
 
-  /* drop the item from the list */
-  icon_view->priv->items = g_list_delete_link (icon_view->priv->items, list);
+  if (G_LIKELY (item != NULL))
+    {
+      if (G_UNLIKELY (item == icon_view->priv->anchor_item || item == icon_view->priv->cursor_item))
+        {
+          /* determine the next item (if any), else the previous one; the
+           * array matches the model again, so both can be materialized
+           */
+          if (idx < EXO_ICON_VIEW_N_ITEMS (icon_view))
+            sibling = EXO_ICON_VIEW_NTH_ITEM (icon_view, idx);
+          else if (idx > 0)
+            sibling = EXO_ICON_VIEW_NTH_ITEM (icon_view, idx - 1);
+          else
+            sibling = NULL;
 
-  /* release the item */
-  g_slice_free (ExoIconViewItem, item);
+          /* use the sibling as anchor, otherwise reset anchor */
+          if (G_UNLIKELY (item == icon_view->priv->anchor_item))
+            icon_view->priv->anchor_item = sibling;
 
-  /* recalculate the layout */
-  exo_icon_view_queue_layout (icon_view);
+          /* use the sibling as cursor, otherwise reset cursor */
+          if (G_UNLIKELY (item == icon_view->priv->cursor_item))
+            icon_view->priv->cursor_item = sibling;
+        }
+
+      /* release the item */
+      exo_icon_view_release_item_size (icon_view, &item->area);
+      exo_icon_view_item_free (icon_view, item);
+    }
+
+  /* recalculate the layout, starting at the position of the deleted item */
+  exo_icon_view_queue_layout_from (icon_view, idx, G_MAXINT);
 
   /* if we removed a previous selected item, we need
    * to tell others that we have a new selection.
    */
   if (G_UNLIKELY (changed))
-    g_signal_emit (G_OBJECT (icon_view), icon_view_signals[SELECTION_CHANGED], 0);
+    exo_icon_view_queue_selection_changed (icon_view);
 }
 
 
@@ -4101,11 +6844,12 @@ exo_icon_view_rows_reordered (GtkTreeModel *model,
                               gint         *new_order,
                               ExoIconView  *icon_view)
 {
-  GList          **list_array;
-  GList           *list;
-  gint            *order;
-  gint              length;
-  gint              i;
+  ExoIconViewItem *item;
+  GPtrArray       *items;
+  gint             length;
+  gint             cursor;
+  gint             anchor;
+  gint             i;
 
   /* cancel any editing attempt */
   exo_icon_view_stop_editing (icon_view, TRUE);
@@ -4115,28 +6859,50 @@ exo_icon_view_rows_reordered (GtkTreeModel *model,
   if (G_UNLIKELY (length == 0))
     return;
 
-  list_array = g_newa (GList *, length);
-  order = g_newa (gint, length);
-
-  for (i = 0; i < length; i++)
-    order[new_order[i]] = i;
-
-  for (i = 0, list = icon_view->priv->items; list != NULL; list = list->next, i++)
-    list_array[order[i]] = list;
-
-  /* hook up the first item */
-  icon_view->priv->items = list_array[0];
-  list_array[0]->prev = NULL;
+  /* while frozen, the items are rebuilt on thaw, and only the positions
+   * that must survive the rebuild move along
+   */
+  if (G_UNLIKELY (icon_view->priv->freeze_count > 0))
+    {
+      exo_icon_view_selection_reorder (&icon_view->priv->selection, length, new_order);
+      if (G_UNLIKELY (icon_view->priv->doing_rubberband))
+        exo_icon_view_selection_reorder (&icon_view->priv->rubberband_selection, length, new_order);
+      exo_icon_view_freeze_items (icon_view, -1, 0, new_order);
+      for (i = 0, cursor = icon_view->priv->frozen_cursor, anchor = icon_view->priv->frozen_anchor; i < length; ++i)
+        {
+          if (new_order[i] == cursor)
+            icon_view->priv->frozen_cursor = i;
+          if (new_order[i] == anchor)
+            icon_view->priv->frozen_anchor = i;
+        }
+      return;
+    }
 
-  /* hook up the remaining items */
-  for (i = 1; i < length; ++i)
+  /* new_order[i] is the former position of the item now at position i */
+  items = g_ptr_array_sized_new (length);
+  g_ptr_array_set_size (items, length);
+  for (i = 0; i < length; ++i)
     {
-      list_array[i - 1]->next = list_array[i];
-      list_array[i]->prev = list_array[i - 1];
+      item = EXO_ICON_VIEW_PEEK_ITEM (icon_view, new_order[i]);
+      if (G_LIKELY (item != NULL))
+        item->index = i;
+      g_ptr_array_index (items, i) = item;
     }
 
-  /* hook up the last item */
-  list_array[length - 1]->next = NULL;
+  /* replace the item array */
+  g_ptr_array_free (icon_view->priv->items, TRUE);
+  icon_view->priv->items = items;
+  exo_icon_view_size_caches_reorder (icon_view, length, new_order);
+  exo_icon_view_search_index_reorder (icon_view, length, new_order);
+
+  /* a running search must start over */
+  if (G_UNLIKELY (icon_view->priv->search_slice_id != 0))
+    icon_view->priv->search_slice_row = icon_view->priv->search_slice_count = 0;
+
+  /* the selected items moved along */
+  exo_icon_view_selection_reorder (&icon_view->priv->selection, length, new_order);
+  if (G_UNLIKELY (icon_view->priv->doing_rubberband))
+    exo_icon_view_selection_reorder (&icon_view->priv->rubberband_selection, length, new_order);
 
   exo_icon_view_queue_layout (icon_view);
 }
@@ -4188,6 +6954,10 @@ exo_icon_view_real_move_cursor (ExoIconView     *icon_view,
   EXO_ICON_VIEW_SET_FLAG (icon_view, EXO_ICON_VIEW_DRAW_KEYFOCUS);
   gtk_widget_grab_focus (GTK_WIDGET (icon_view));
 
+  /* the neighbours of the cursor are looked up in the lines of the layout */
+  if (G_UNLIKELY (icon_view->priv->layout_idle_id != 0))
+    exo_icon_view_layout (icon_view);
+
   if (gtk_get_current_event_state (&state))
     {
       if ((state & GDK_CONTROL_MASK) == GDK_CONTROL_MASK)
@@ -4312,37 +7082,99 @@ find_item_page_up_down (ExoIconView     *icon_view,
                         ExoIconViewItem *current,
                         gint             count)
 {
-  GList *item = g_list_find (icon_view->priv->items, current);
-  GList *next;
-  gint   col = current->col;
-  gint   y = current->area.y + count * gtk_adjustment_get_page_size (icon_view->priv->vadjustment);
+  const ExoIconViewLine *lines = (const ExoIconViewLine *) icon_view->priv->lines->data;
+  ExoIconViewItem       *item;
+  gint                   n_lines = icon_view->priv->lines->len;
+  gint                   focus_width;
+  gint                   current_line;
+  gint                   line;
+  gint                   first;
+  gint                   last;
+  gint                   lower;
+  gint                   upper;
+  gint                   mid;
+  gint                   y = current->area.y + count * gtk_adjustment_get_page_size (icon_view->priv->vadjustment);
+
+  if (G_UNLIKELY (n_lines == 0))
+    return current;
+
+  line = current_line = exo_icon_view_get_item_line (icon_view, current);
 
-  if (count > 0)
+  if (G_LIKELY (icon_view->priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
     {
-      for (; item != NULL; item = item->next)
+      gtk_widget_style_get (GTK_WIDGET (icon_view),
+                            "focus-line-width", &focus_width,
+                            NULL);
+
+      /* lookup the last row starting above y when moving down, or the first
+       * row starting below y when moving up (the rows are sorted)
+       */
+      if (count > 0)
         {
-          for (next = item->next; next; next = next->next)
-            if (EXO_ICON_VIEW_ITEM (next->data)->col == col)
-              break;
+          for (lower = line, upper = n_lines; lower < upper; )
+            {
+              mid = (lower + upper) / 2;
+              if (lines[mid].start + focus_width <= y)
+                lower = mid + 1;
+              else
+                upper = mid;
+            }
+          line = MAX (line, lower - 1);
+        }
+      else
+        {
+          for (lower = 0, upper = line; lower < upper; )
+            {
+              mid = (lower + upper) / 2;
+              if (lines[mid].start + focus_width < y)
+                lower = mid + 1;
+              else
+                upper = mid;
+            }
+          line = lower;
+        }
 
-          if (next == NULL || EXO_ICON_VIEW_ITEM (next->data)->area.y > y)
+      /* go back towards the current row until a row has an item in the column */
+      for (;;)
+        {
+          item = exo_icon_view_get_item_on_line (icon_view, line, current->col);
+          if (item != NULL || line == current_line)
             break;
+          line += (count > 0) ? -1 : 1;
         }
     }
   else
     {
-      for (; item != NULL; item = item->prev)
+      /* the items of a column are sorted by their position */
+      first = lines[line].first;
+      last = (line + 1 < n_lines) ? lines[line + 1].first : EXO_ICON_VIEW_N_ITEMS (icon_view);
+      if (count > 0)
         {
-          for (next = item->prev; next; next = next->prev)
-            if (EXO_ICON_VIEW_ITEM (next->data)->col == col)
-              break;
-
-          if (next == NULL || EXO_ICON_VIEW_ITEM (next->data)->area.y < y)
-            break;
+          for (lower = current->index, upper = last; lower < upper; )
+            {
+              mid = (lower + upper) / 2;
+              if (EXO_ICON_VIEW_NTH_ITEM (icon_view, mid)->area.y <= y)
+                lower = mid + 1;
+              else
+                upper = mid;
+            }
+          item = EXO_ICON_VIEW_NTH_ITEM (icon_view, MAX (current->index, lower - 1));
+        }
+      else
+        {
+          for (lower = first, upper = current->index; lower < upper; )
+            {
+              mid = (lower + upper) / 2;
+              if (EXO_ICON_VIEW_NTH_ITEM (icon_view, mid)->area.y < y)
+                lower = mid + 1;
+              else
+                upper = mid;
+            }
+          item = EXO_ICON_VIEW_NTH_ITEM (icon_view, lower);
         }
     }
 
-  return (item != NULL) ? item->data : NULL;
+  return (item != NULL) ? item : current;
 }
 
 
@@ -4352,40 +7184,23 @@ exo_icon_view_select_all_between (ExoIconView     *icon_view,
                                   ExoIconViewItem *anchor,
                                   ExoIconViewItem *cursor)
 {
-  GList *items;
-  ExoIconViewItem *item, *last = NULL;
-  gboolean dirty = FALSE;
-
-  for (items = icon_view->priv->items; items; items = items->next)
-    {
-      item = items->data;
-
-      if (item == anchor)
-        {
-          last = cursor;
-          break;
-        }
-      else if (item == cursor)
-        {
-          last = anchor;
-          break;
-        }
-    }
+  gboolean dirty;
+  gint     first;
+  gint     last;
+  gint     n;
 
-  for (; items; items = items->next)
-    {
-      item = items->data;
-
-      if (!item->selected)
-        dirty = TRUE;
+  /* the item indices tell which one comes first */
+  first = MIN (anchor->index, cursor->index);
+  last = MAX (anchor->index, cursor->index);
 
-      item->selected = TRUE;
-
-      exo_icon_view_queue_draw_item (icon_view, item);
+  /* select the whole range at once */
+  dirty = !exo_icon_view_selection_contains_range (&icon_view->priv->selection, first, last + 1);
+  exo_icon_view_selection_select_range (&icon_view->priv->selection, first, last + 1);
 
-      if (item == last)
-        break;
-    }
+  /* items that were not materialized yet were never drawn */
+  for (n = first; n <= last; ++n)
+    if (EXO_ICON_VIEW_PEEK_ITEM (icon_view, n) != NULL)
+      exo_icon_view_queue_draw_item (icon_view, EXO_ICON_VIEW_PEEK_ITEM (icon_view, n));
 
   return dirty;
 }
@@ -4398,7 +7213,7 @@ exo_icon_view_move_cursor_up_down (ExoIconView *icon_view,
 {
   ExoIconViewItem  *item;
   gboolean          dirty = FALSE;
-  GList            *list;
+  gint              n;
   gint              cell = -1;
   gint              step;
   GtkDirectionType  direction;
@@ -4411,12 +7226,12 @@ exo_icon_view_move_cursor_up_down (ExoIconView *icon_view,
 
   if (!icon_view->priv->cursor_item)
     {
-      if (count > 0)
-        list = icon_view->priv->items;
+      if (G_UNLIKELY (EXO_ICON_VIEW_N_ITEMS (icon_view) == 0))
+        item = NULL;
+      else if (count > 0)
+        item = EXO_ICON_VIEW_NTH_ITEM (icon_view, 0);
       else
-        list = g_list_last (icon_view->priv->items);
-
-      item = list ? list->data : NULL;
+        item = EXO_ICON_VIEW_NTH_ITEM (icon_view, EXO_ICON_VIEW_N_ITEMS (icon_view) - 1);
     }
   else
     {
@@ -4431,35 +7246,17 @@ exo_icon_view_move_cursor_up_down (ExoIconView *icon_view,
           if (count == 0)
             break;
 
-          /* determine the list position for the item */
-          list = g_list_find (icon_view->priv->items, item);
-
           if (G_LIKELY (icon_view->priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
             {
-              /* determine the item in the next/prev row */
-              if (step > 0)
-                {
-                  for (list = list->next; list != NULL; list = list->next)
-                    if (EXO_ICON_VIEW_ITEM (list->data)->row == item->row + step
-                        && EXO_ICON_VIEW_ITEM (list->data)->col == item->col)
-                      break;
-                 }
-              else
-                {
-                  for (list = list->prev; list != NULL; list = list->prev)
-                    if (EXO_ICON_VIEW_ITEM (list->data)->row == item->row + step
-                        && EXO_ICON_VIEW_ITEM (list->data)->col == item->col)
-                      break;
-                }
+              /* determine the item in the same column of the next/prev row */
+              item = exo_icon_view_get_item_on_line (icon_view, exo_icon_view_get_item_line (icon_view, item) + step, item->col);
             }
           else
             {
-              list = (step > 0) ? list->next : list->prev;
+              n = item->index + step;
+              item = (n >= 0 && n < EXO_ICON_VIEW_N_ITEMS (icon_view)) ? EXO_ICON_VIEW_NTH_ITEM (icon_view, n) : NULL;
             }
 
-          /* check if we found a matching item */
-          item = (list != NULL) ? list->data : NULL;
-
           count = count - step;
         }
     }
@@ -4482,7 +7279,7 @@ exo_icon_view_move_cursor_up_down (ExoIconView *icon_view,
 
       /* check if we should select the cursor item */
       item = icon_view->priv->cursor_item;
-      if (!item || item->selected)
+      if (!item || EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item))
         return;
     }
 
@@ -4506,7 +7303,7 @@ exo_icon_view_move_cursor_up_down (ExoIconView *icon_view,
   exo_icon_view_scroll_to_item (icon_view, item);
 
   if (dirty)
-    g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+    exo_icon_view_queue_selection_changed (icon_view);
 }
 
 
@@ -4523,14 +7320,12 @@ exo_icon_view_move_cursor_page_up_down (ExoIconView *icon_view,
 
   if (!icon_view->priv->cursor_item)
     {
-      GList *list;
-
-      if (count > 0)
-        list = icon_view->priv->items;
+      if (G_UNLIKELY (EXO_ICON_VIEW_N_ITEMS (icon_view) == 0))
+        item = NULL;
+      else if (count > 0)
+        item = EXO_ICON_VIEW_NTH_ITEM (icon_view, 0);
       else
-        list = g_list_last (icon_view->priv->items);
-
-      item = list ? list->data : NULL;
+        item = EXO_ICON_VIEW_NTH_ITEM (icon_view, EXO_ICON_VIEW_N_ITEMS (icon_view) - 1);
     }
   else
     item = find_item_page_up_down (icon_view,
@@ -4560,7 +7355,7 @@ exo_icon_view_move_cursor_page_up_down (ExoIconView *icon_view,
   exo_icon_view_scroll_to_item (icon_view, item);
 
   if (dirty)
-    g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+    exo_icon_view_queue_selection_changed (icon_view);
 }
 
 
@@ -4571,7 +7366,7 @@ exo_icon_view_move_cursor_left_right (ExoIconView *icon_view,
 {
   ExoIconViewItem  *item;
   gboolean          dirty = FALSE;
-  GList            *list;
+  gint              n;
   gint              cell = -1;
   gint              step;
   GtkDirectionType  direction;
@@ -4587,12 +7382,12 @@ exo_icon_view_move_cursor_left_right (ExoIconView *icon_view,
 
   if (!icon_view->priv->cursor_item)
     {
-      if (count > 0)
-        list = icon_view->priv->items;
+      if (G_UNLIKELY (EXO_ICON_VIEW_N_ITEMS (icon_view) == 0))
+        item = NULL;
+      else if (count > 0)
+        item = EXO_ICON_VIEW_NTH_ITEM (icon_view, 0);
       else
-        list = g_list_last (icon_view->priv->items);
-
-      item = list ? list->data : NULL;
+        item = EXO_ICON_VIEW_NTH_ITEM (icon_view, EXO_ICON_VIEW_N_ITEMS (icon_view) - 1);
     }
   else
     {
@@ -4607,39 +7402,21 @@ exo_icon_view_move_cursor_left_right (ExoIconView *icon_view,
           if (count == 0)
             break;
 
-          /* lookup the item in the list */
-          list = g_list_find (icon_view->priv->items, item);
-
           if (G_LIKELY (icon_view->priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
             {
-              /* determine the next/prev list item depending on step,
+              /* determine the next/prev item depending on step,
                * support wrapping around on the edges, as requested
                * in https://bugzilla.xfce.org/show_bug.cgi?id=1623.
                */
-              list = (step > 0) ? list->next : list->prev;
+              n = item->index + step;
+              item = (n >= 0 && n < EXO_ICON_VIEW_N_ITEMS (icon_view)) ? EXO_ICON_VIEW_NTH_ITEM (icon_view, n) : NULL;
             }
           else
             {
-              /* determine the item in the next/prev row */
-              if (step > 0)
-                {
-                  for (list = list->next; list != NULL; list = list->next)
-                    if (EXO_ICON_VIEW_ITEM (list->data)->col == item->col + step
-                        && EXO_ICON_VIEW_ITEM (list->data)->row == item->row)
-                      break;
-                 }
-              else
-                {
-                  for (list = list->prev; list != NULL; list = list->prev)
-                    if (EXO_ICON_VIEW_ITEM (list->data)->col == item->col + step
-                        && EXO_ICON_VIEW_ITEM (list->data)->row == item->row)
-                      break;
-                }
+              /* determine the item in the same row of the next/prev column */
+              item = exo_icon_view_get_item_on_line (icon_view, exo_icon_view_get_item_line (icon_view, item) + step, item->row);
             }
 
-          /* determine the item for the list position (if any) */
-          item = (list != NULL) ? list->data : NULL;
-
           count = count - step;
         }
     }
@@ -4662,7 +7439,7 @@ exo_icon_view_move_cursor_left_right (ExoIconView *icon_view,
 
       /* check if we should select the cursor item */
       item = icon_view->priv->cursor_item;
-      if (!item || item->selected)
+      if (!item || EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item))
         return;
     }
 
@@ -4686,7 +7463,7 @@ exo_icon_view_move_cursor_left_right (ExoIconView *icon_view,
   exo_icon_view_scroll_to_item (icon_view, item);
 
   if (dirty)
-    g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+    exo_icon_view_queue_selection_changed (icon_view);
 }
 
 
@@ -4697,16 +7474,14 @@ exo_icon_view_move_cursor_start_end (ExoIconView *icon_view,
 {
   ExoIconViewItem *item;
   gboolean         dirty = FALSE;
-  GList           *lp;
 
   if (!gtk_widget_has_focus (GTK_WIDGET (icon_view)))
     return;
 
-  lp = (count < 0) ? icon_view->priv->items : g_list_last (icon_view->priv->items);
-  if (G_UNLIKELY (lp == NULL))
+  if (G_UNLIKELY (EXO_ICON_VIEW_N_ITEMS (icon_view) == 0))
     return;
 
-  item = EXO_ICON_VIEW_ITEM (lp->data);
+  item = EXO_ICON_VIEW_NTH_ITEM (icon_view, (count < 0) ? 0 : EXO_ICON_VIEW_N_ITEMS (icon_view) - 1);
   if (icon_view->priv->ctrl_pressed ||
       !icon_view->priv->shift_pressed ||
       !icon_view->priv->anchor_item ||
@@ -4727,7 +7502,7 @@ exo_icon_view_move_cursor_start_end (ExoIconView *icon_view,
   exo_icon_view_scroll_to_item (icon_view, item);
 
   if (G_UNLIKELY (dirty))
-    g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+    exo_icon_view_queue_selection_changed (icon_view);
 }
 
 
@@ -4747,6 +7522,8 @@ exo_icon_view_get_item_needed_size (ExoIconView     *icon_view,
   *width = 0;
   *height = 0;
 
+  exo_icon_view_refine_item (icon_view, item);
+
   for (lp = icon_view->priv->cell_list; lp != NULL; lp = lp->next)
     {
       info = EXO_ICON_VIEW_CELL_INFO (lp->data);
@@ -4789,7 +7566,7 @@ exo_icon_view_scroll_to_item (ExoIconView     *icon_view,
 
       /* remember a reference for the new path and settings */
 
-      path = gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1);
+      path = gtk_tree_path_new_from_indices (item->index, -1);
       icon_view->priv->scroll_to_path = gtk_tree_row_reference_new_proxy (G_OBJECT (icon_view), icon_view->priv->model, path);
       gtk_tree_path_free (path);
 
@@ -4866,16 +7643,33 @@ static void
 exo_icon_view_set_cell_data (const ExoIconView *icon_view,
                              ExoIconViewItem   *item)
 {
-  ExoIconViewCellInfo *info;
-  GtkTreePath         *path;
-  GtkTreeIter          iter;
-  GValue               value = {0, };
-  GSList              *slp;
-  GList               *lp;
+  const ExoIconViewAttribute *attribute;
+  ExoIconViewCellInfo        *info;
+  GtkTreePath                *path;
+  GtkTreeIter                 iter;
+  GValue                      value = {0, };
+  gboolean                    text_only;
+  gboolean                    cached;
+  GList                      *lp;
+  guint                       n;
+
+  /* the attributes were already set for this item and didn't change
+   * since, so only the cell data functions need to be run again.
+   */
+  cached = (icon_view->priv->cell_data_item == item);
+  if (G_LIKELY (cached))
+    {
+      for (lp = icon_view->priv->cell_list; lp != NULL; lp = lp->next)
+        if (EXO_ICON_VIEW_CELL_INFO (lp->data)->func != NULL)
+          break;
+
+      if (G_LIKELY (lp == NULL))
+        return;
+    }
 
   if (G_UNLIKELY (!EXO_ICON_VIEW_FLAG_SET (icon_view, EXO_ICON_VIEW_ITERS_PERSIST)))
     {
-      path = gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1);
+      path = gtk_tree_path_new_from_indices (item->index, -1);
       gtk_tree_model_get_iter (icon_view->priv->model, &iter, path);
       gtk_tree_path_free (path);
     }
@@ -4888,16 +7682,94 @@ exo_icon_view_set_cell_data (const ExoIconView *icon_view,
     {
       info = EXO_ICON_VIEW_CELL_INFO (lp->data);
 
-      for (slp = info->attributes; slp != NULL && slp->next != NULL; slp = slp->next->next)
+      if (!cached && info->attributes != NULL)
         {
-          gtk_tree_model_get_value (icon_view->priv->model, &iter, GPOINTER_TO_INT (slp->next->data), &value);
-          g_object_set_property (G_OBJECT (info->cell), slp->data, &value);
-          g_value_unset (&value);
+          /* emit the property notifications once per cell */
+          g_object_freeze_notify (G_OBJECT (info->cell));
+          text_only = TRUE;
+
+          for (n = 0; n < info->attributes->len; ++n)
+            {
+              attribute = &g_array_index (info->attributes, ExoIconViewAttribute, n);
+              gtk_tree_model_get_value (icon_view->priv->model, &iter, attribute->column, &value);
+              g_object_set_property (G_OBJECT (info->cell), attribute->pspec->name, &value);
+
+              /* remember the string to look up the size of the text cell, values
+               * of other types are converted by the renderer and not cached */
+              if (info->text_extents != NULL
+                  && (strcmp (attribute->pspec->name, "text") == 0 || strcmp (attribute->pspec->name, "markup") == 0))
+                {
+                  g_free (info->text);
+                  info->text = G_VALUE_HOLDS_STRING (&value) ? g_value_dup_string (&value) : NULL;
+                  info->text_is_markup = (attribute->pspec->name[0] == 'm');
+                }
+              else
+                {
+                  /* other bound properties (font, weight, scale, attributes,
+                   * ...) may change the size per item, and are not in the key */
+                  text_only = FALSE;
+                }
+
+              g_value_unset (&value);
+            }
+
+          /* the size of the string alone is only known without them */
+          if (G_UNLIKELY (!text_only && info->text != NULL))
+            {
+              g_free (info->text);
+              info->text = NULL;
+            }
+
+          g_object_thaw_notify (G_OBJECT (info->cell));
         }
 
       if (G_UNLIKELY (info->func != NULL))
         (*info->func) (GTK_CELL_LAYOUT (icon_view), info->cell, icon_view->priv->model, &iter, info->func_data);
     }
+
+  icon_view->priv->cell_data_item = item;
+}
+
+
+
+static void
+exo_icon_view_text_cell_notify (GtkCellRenderer *cell,
+                                GParamSpec      *pspec,
+                                ExoIconView     *icon_view)
+{
+  const ExoIconViewAttribute *attribute;
+  ExoIconViewCellInfo        *info;
+  guint                       n;
+
+  info = exo_icon_view_get_cell_info (icon_view, cell);
+  if (G_UNLIKELY (info == NULL || info->text_extents == NULL))
+    return;
+
+  /* the wrap width is part of the cache key */
+  if (strcmp (pspec->name, "wrap-width") == 0)
+    {
+      g_object_get (G_OBJECT (cell), "wrap-width", &info->wrap_width, NULL);
+      return;
+    }
+
+  /* the bound properties change with every item, the sizes are only
+   * cached if the text or markup is the only one, and never for cells
+   * with a data function
+   */
+  if (info->func != NULL)
+    return;
+  if (info->attributes != NULL)
+    {
+      for (n = 0; n < info->attributes->len; ++n)
+        {
+          attribute = &g_array_index (info->attributes, ExoIconViewAttribute, n);
+          if (strcmp (attribute->pspec->name, pspec->name) == 0)
+            return;
+        }
+    }
+
+  /* anything else may change the size of every string */
+  g_hash_table_remove_all (info->text_extents);
 }
 
 
@@ -4905,12 +7777,15 @@ exo_icon_view_set_cell_data (const ExoIconView *icon_view,
 static void
 free_cell_attributes (ExoIconViewCellInfo *info)
 {
-  GSList *lp;
+  if (G_LIKELY (info->attributes != NULL))
+    {
+      g_array_free (info->attributes, TRUE);
+      info->attributes = NULL;
+    }
 
-  for (lp = info->attributes; lp != NULL && lp->next != NULL; lp = lp->next->next)
-    g_free (lp->data);
-  g_slist_free (info->attributes);
-  info->attributes = NULL;
+  /* the remembered string came from a binding */
+  g_free (info->text);
+  info->text = NULL;
 }
 
 
@@ -4922,6 +7797,13 @@ free_cell_info (ExoIconViewCellInfo *info)
     (*info->destroy) (info->func_data);
 
   free_cell_attributes (info);
+
+  if (info->text_extents != NULL)
+    {
+      g_signal_handlers_disconnect_matched (G_OBJECT (info->cell), G_SIGNAL_MATCH_FUNC, 0, 0, NULL, exo_icon_view_text_cell_notify, NULL);
+      g_hash_table_destroy (info->text_extents);
+    }
+
   g_object_unref (G_OBJECT (info->cell));
   g_slice_free (ExoIconViewCellInfo, info);
 }
@@ -4948,6 +7830,15 @@ exo_icon_view_cell_layout_pack_start (GtkCellLayout   *layout,
   info->position = icon_view->priv->n_cells;
   info->is_text = GTK_IS_CELL_RENDERER_TEXT (renderer);
 
+  if (info->is_text)
+    {
+      /* remember the measured text sizes until the renderer changes */
+      info->text_extents = g_hash_table_new_full (exo_icon_view_text_extents_hash, exo_icon_view_text_extents_equal,
+                                                  exo_icon_view_text_extents_free, NULL);
+      g_object_get (G_OBJECT (renderer), "wrap-width", &info->wrap_width, NULL);
+      g_signal_connect (G_OBJECT (renderer), "notify", G_CALLBACK (exo_icon_view_text_cell_notify), icon_view);
+    }
+
   icon_view->priv->cell_list = g_list_append (icon_view->priv->cell_list, info);
   icon_view->priv->n_cells++;
 
@@ -4976,6 +7867,15 @@ exo_icon_view_cell_layout_pack_end (GtkCellLayout   *layout,
   info->position = icon_view->priv->n_cells;
   info->is_text = GTK_IS_CELL_RENDERER_TEXT (renderer);
 
+  if (info->is_text)
+    {
+      /* remember the measured text sizes until the renderer changes */
+      info->text_extents = g_hash_table_new_full (exo_icon_view_text_extents_hash, exo_icon_view_text_extents_equal,
+                                                  exo_icon_view_text_extents_free, NULL);
+      g_object_get (G_OBJECT (renderer), "wrap-width", &info->wrap_width, NULL);
+      g_signal_connect (G_OBJECT (renderer), "notify", G_CALLBACK (exo_icon_view_text_cell_notify), icon_view);
+    }
+
   icon_view->priv->cell_list = g_list_append (icon_view->priv->cell_list, info);
   icon_view->priv->n_cells++;
 
@@ -4990,13 +7890,25 @@ exo_icon_view_cell_layout_add_attribute (GtkCellLayout   *layout,
                                          const gchar     *attribute,
                                          gint             column)
 {
+  ExoIconViewAttribute binding;
   ExoIconViewCellInfo *info;
 
   info = exo_icon_view_get_cell_info (EXO_ICON_VIEW (layout), renderer);
   if (G_LIKELY (info != NULL))
     {
-      info->attributes = g_slist_prepend (info->attributes, GINT_TO_POINTER (column));
-      info->attributes = g_slist_prepend (info->attributes, g_strdup (attribute));
+      /* look up the property once, instead of for every item */
+      binding.pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (renderer), attribute);
+      if (G_UNLIKELY (binding.pspec == NULL || (binding.pspec->flags & G_PARAM_WRITABLE) == 0))
+        {
+          g_warning ("%s has no writable property named \"%s\"", G_OBJECT_TYPE_NAME (renderer), attribute);
+          return;
+        }
+      binding.column = column;
+
+      /* the last added attribute is applied first */
+      if (G_UNLIKELY (info->attributes == NULL))
+        info->attributes = g_array_new (FALSE, FALSE, sizeof (ExoIconViewAttribute));
+      g_array_prepend_val (info->attributes, binding);
 
       exo_icon_view_invalidate_sizes (EXO_ICON_VIEW (layout));
     }
@@ -5212,7 +8124,7 @@ exo_icon_view_get_path_at_pos (const ExoIconView *icon_view,
 
   item = exo_icon_view_get_item_at_coords (icon_view, x, y, TRUE, NULL);
 
-  return (item != NULL) ? gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1) : NULL;
+  return (item != NULL) ? gtk_tree_path_new_from_indices (item->index, -1) : NULL;
 }
 
 
@@ -5250,7 +8162,7 @@ exo_icon_view_get_item_at_pos (const ExoIconView *icon_view,
   item = exo_icon_view_get_item_at_coords (icon_view, x, y, TRUE, &info);
 
   if (G_LIKELY (path != NULL))
-    *path = (item != NULL) ? gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1) : NULL;
+    *path = (item != NULL) ? gtk_tree_path_new_from_indices (item->index, -1) : NULL;
 
   if (G_LIKELY (cell != NULL))
     *cell = (info != NULL) ? info->cell : NULL;
@@ -5282,9 +8194,10 @@ exo_icon_view_get_visible_range (const ExoIconView *icon_view,
 {
   const ExoIconViewPrivate *priv = icon_view->priv;
   const ExoIconViewItem    *item;
-  const GList              *lp;
   gint                      start_index = -1;
   gint                      end_index = -1;
+  gint                      first_item;
+  gint                      last_item;
   gint                      i;
 
   g_return_val_if_fail (EXO_IS_ICON_VIEW (icon_view), FALSE);
@@ -5295,9 +8208,23 @@ exo_icon_view_get_visible_range (const ExoIconView *icon_view,
   if (start_path == NULL && end_path == NULL)
     return FALSE;
 
-  for (i = 0, lp = priv->items; lp != NULL; ++i, lp = lp->next)
+  /* determine the lines within the visible area */
+  if (G_LIKELY (priv->layout_mode == EXO_ICON_VIEW_LAYOUT_ROWS))
+    {
+      exo_icon_view_get_line_items (icon_view, (gint) gtk_adjustment_get_value (priv->vadjustment),
+                                    (gint) (gtk_adjustment_get_value (priv->vadjustment) + gtk_adjustment_get_page_size (priv->vadjustment)),
+                                    &first_item, &last_item);
+    }
+  else
+    {
+      exo_icon_view_get_line_items (icon_view, (gint) gtk_adjustment_get_value (priv->hadjustment),
+                                    (gint) (gtk_adjustment_get_value (priv->hadjustment) + gtk_adjustment_get_page_size (priv->hadjustment)),
+                                    &first_item, &last_item);
+    }
+
+  for (i = first_item; i < last_item; ++i)
     {
-      item = (const ExoIconViewItem *) lp->data;
+      item = EXO_ICON_VIEW_NTH_ITEM (icon_view, i);
       if ((item->area.x + item->area.width >= (gint) gtk_adjustment_get_value (priv->hadjustment)) &&
           (item->area.y + item->area.height >= (gint) gtk_adjustment_get_value (priv->vadjustment)) &&
           (item->area.x <= (gint) (gtk_adjustment_get_value (priv->hadjustment) + gtk_adjustment_get_page_size (priv->hadjustment))) &&
@@ -5334,16 +8261,21 @@ exo_icon_view_selected_foreach (ExoIconView           *icon_view,
                                 gpointer               data)
 {
   GtkTreePath *path;
-  GList       *lp;
+  gint         start;
+  gint         end;
+  gint         n;
 
-  path = gtk_tree_path_new_first ();
-  for (lp = icon_view->priv->items; lp != NULL; lp = lp->next)
+  /* only visit the selected items */
+  for (n = 0; exo_icon_view_selection_next_range (&icon_view->priv->selection, EXO_ICON_VIEW_N_ITEMS (icon_view), n, &start, &end); n = end)
     {
-      if (EXO_ICON_VIEW_ITEM (lp->data)->selected)
-        (*func) (icon_view, path, data);
-      gtk_tree_path_next (path);
+      path = gtk_tree_path_new_from_indices (start, -1);
+      for (; start < end; ++start)
+        {
+          (*func) (icon_view, path, data);
+          gtk_tree_path_next (path);
+        }
+      gtk_tree_path_free (path);
     }
-  gtk_tree_path_free (path);
 }
 
 
@@ -5435,11 +8367,7 @@ exo_icon_view_set_layout_mode (ExoIconView          *icon_view,
       /* cancel any active cell editor */
       exo_icon_view_stop_editing (icon_view, TRUE);
 
-      /* invalidate the current item sizes */
-      exo_icon_view_invalidate_sizes (icon_view);
-      exo_icon_view_queue_layout (icon_view);
-
-      /* notify listeners */
+      /* notify listeners (which also invalidates the current item sizes) */
       g_object_notify (G_OBJECT (icon_view), "layout-mode");
     }
 }
@@ -5478,11 +8406,7 @@ void
 exo_icon_view_set_model (ExoIconView  *icon_view,
                          GtkTreeModel *model)
 {
-  ExoIconViewItem *item;
-  GtkTreeIter      iter;
-  GList           *items = NULL;
-  GList           *lp;
-  gint             n;
+  gint n;
 
   g_return_if_fail (EXO_IS_ICON_VIEW (icon_view));
   g_return_if_fail (model == NULL || GTK_IS_TREE_MODEL (model));
@@ -5525,30 +8449,11 @@ exo_icon_view_set_model (ExoIconView  *icon_view,
       g_object_unref (G_OBJECT (icon_view->priv->model));
 
       /* drop all items belonging to the previous model */
-      for (lp = icon_view->priv->items; lp != NULL; lp = lp->next)
-        {
-          g_free (EXO_ICON_VIEW_ITEM (lp->data)->box);
-          g_slice_free (ExoIconViewItem, lp->data);
-        }
-      g_list_free (icon_view->priv->items);
-      icon_view->priv->items = NULL;
+      exo_icon_view_drop_items (icon_view);
+      exo_icon_view_reset_items (icon_view);
 
       /* reset statistics */
       icon_view->priv->search_column = -1;
-      icon_view->priv->anchor_item = NULL;
-      icon_view->priv->cursor_item = NULL;
-      icon_view->priv->prelit_item = NULL;
-      icon_view->priv->last_single_clicked = NULL;
-      icon_view->priv->width = 0;
-      icon_view->priv->height = 0;
-
-      /* cancel any pending single click timer */
-      if (G_UNLIKELY (icon_view->priv->single_click_timeout_id != 0))
-        g_source_remove (icon_view->priv->single_click_timeout_id);
-
-      /* reset cursor when in single click mode and realized */
-      if (G_UNLIKELY (icon_view->priv->single_click && gtk_widget_get_realized (GTK_WIDGET (icon_view))))
-        gdk_window_set_cursor (icon_view->priv->bin_window, NULL);
     }
 
   /* be sure to drop any previous scroll_to_path reference,
@@ -5593,20 +8498,8 @@ exo_icon_view_set_model (ExoIconView  *icon_view,
               }
         }
 
-      /* build up the initial items list */
-      if (gtk_tree_model_get_iter_first (model, &iter))
-        {
-          n = 0;
-          do
-            {
-              item = g_slice_new0 (ExoIconViewItem);
-              item->iter = iter;
-              item->area.width = -1;
-              items = g_list_prepend (items, item);
-            }
-          while (gtk_tree_model_iter_next (model, &iter));
-        }
-      icon_view->priv->items = g_list_reverse (items);
+      /* build up the initial items array */
+      exo_icon_view_build_items (icon_view);
 
       /* layout the new items */
       exo_icon_view_queue_layout (icon_view);
@@ -5625,6 +8518,92 @@ exo_icon_view_set_model (ExoIconView  *icon_view,
 
 
 
+/**
+ * exo_icon_view_freeze_updates:
+ * @icon_view : A #ExoIconView.
+ *
+ * Stops @icon_view from following the changes of its model until
+ * exo_icon_view_thaw_updates() is called, which is useful when
+ * loading or replacing many rows at once. If rows are inserted,
+ * deleted or reordered meanwhile, @icon_view rebuilds its items in
+ * a single pass on thaw, keeping the selection and the cursor on
+ * the same rows. No layout is done while @icon_view is frozen, and
+ * the items visible before the first such change are drawn until then.
+ *
+ * Calls to this function nest, @icon_view is thawed again with the
+ * last matching call to exo_icon_view_thaw_updates().
+ *
+ * Since: 4.16
+ **/
+void
+exo_icon_view_freeze_updates (ExoIconView *icon_view)
+{
+  g_return_if_fail (EXO_IS_ICON_VIEW (icon_view));
+
+  icon_view->priv->freeze_count += 1;
+}
+
+
+
+/**
+ * exo_icon_view_thaw_updates:
+ * @icon_view : A #ExoIconView.
+ *
+ * Reverts the effect of a previous call to exo_icon_view_freeze_updates().
+ * Once thawed, @icon_view catches up with the changes of its model and
+ * lays out its items again.
+ *
+ * Since: 4.16
+ **/
+void
+exo_icon_view_thaw_updates (ExoIconView *icon_view)
+{
+  gint n_items;
+
+  g_return_if_fail (EXO_IS_ICON_VIEW (icon_view));
+  g_return_if_fail (icon_view->priv->freeze_count > 0);
+
+  icon_view->priv->freeze_count -= 1;
+  if (icon_view->priv->freeze_count > 0)
+    return;
+
+  if (icon_view->priv->frozen_items != NULL)
+    {
+      /* the accessible has its children back */
+      exo_icon_view_accessible_items_rebuilt (icon_view);
+      exo_icon_view_drop_items (icon_view);
+
+      /* catch up with the model in one pass */
+      exo_icon_view_build_items (icon_view);
+
+      /* the selection followed the model, the cursor and the anchor are
+       * placed on the rows they followed as well
+       */
+      n_items = EXO_ICON_VIEW_N_ITEMS (icon_view);
+      if (icon_view->priv->frozen_cursor >= 0 && n_items > 0)
+        icon_view->priv->cursor_item = EXO_ICON_VIEW_NTH_ITEM (icon_view, MIN (icon_view->priv->frozen_cursor, n_items - 1));
+      if (icon_view->priv->frozen_anchor >= 0 && n_items > 0)
+        icon_view->priv->anchor_item = EXO_ICON_VIEW_NTH_ITEM (icon_view, MIN (icon_view->priv->frozen_anchor, n_items - 1));
+
+      /* report the selection changes held back while frozen */
+      if (icon_view->priv->selection_changed_pending)
+        {
+          icon_view->priv->selection_changed_pending = FALSE;
+          exo_icon_view_queue_selection_changed (icon_view);
+        }
+
+      exo_icon_view_queue_layout (icon_view);
+    }
+  else
+    {
+      /* run the layout deferred while frozen */
+      if (icon_view->priv->layout_dirty_first <= icon_view->priv->layout_dirty_last)
+        exo_icon_view_queue_layout_from (icon_view, G_MAXINT, -1);
+    }
+}
+
+
+
 static void
 update_text_cell (ExoIconView *icon_view)
 {
@@ -5770,7 +8749,7 @@ exo_icon_view_select_path (ExoIconView *icon_view,
   g_return_if_fail (icon_view->priv->model != NULL);
   g_return_if_fail (gtk_tree_path_get_depth (path) > 0);
 
-  item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices(path)[0]);
+  item = exo_icon_view_get_item_for_path (icon_view, path);
   if (G_LIKELY (item != NULL))
     exo_icon_view_select_item (icon_view, item);
 }
@@ -5794,7 +8773,7 @@ exo_icon_view_unselect_path (ExoIconView *icon_view,
   g_return_if_fail (icon_view->priv->model != NULL);
   g_return_if_fail (gtk_tree_path_get_depth (path) > 0);
 
-  item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices(path)[0]);
+  item = exo_icon_view_get_item_for_path (icon_view, path);
   if (G_LIKELY (item != NULL))
     exo_icon_view_unselect_item (icon_view, item);
 }
@@ -5822,16 +8801,15 @@ GList*
 exo_icon_view_get_selected_items (const ExoIconView *icon_view)
 {
   GList *selected = NULL;
-  GList *lp;
-  gint   i;
+  gint   start;
+  gint   end;
+  gint   n;
 
   g_return_val_if_fail (EXO_IS_ICON_VIEW (icon_view), NULL);
 
-  for (i = 0, lp = icon_view->priv->items; lp != NULL; ++i, lp = lp->next)
-    {
-      if (EXO_ICON_VIEW_ITEM (lp->data)->selected)
-        selected = g_list_prepend (selected, gtk_tree_path_new_from_indices (i, -1));
-    }
+  for (n = 0; exo_icon_view_selection_next_range (&icon_view->priv->selection, EXO_ICON_VIEW_N_ITEMS (icon_view), n, &start, &end); n = end)
+    for (; start < end; ++start)
+      selected = g_list_prepend (selected, gtk_tree_path_new_from_indices (start, -1));
 
   return g_list_reverse (selected);
 }
@@ -5848,28 +8826,23 @@ exo_icon_view_get_selected_items (const ExoIconView *icon_view)
 void
 exo_icon_view_select_all (ExoIconView *icon_view)
 {
-  GList *items;
-  gboolean dirty = FALSE;
-
   g_return_if_fail (EXO_IS_ICON_VIEW (icon_view));
 
   if (icon_view->priv->selection_mode != GTK_SELECTION_MULTIPLE)
     return;
 
-  for (items = icon_view->priv->items; items; items = items->next)
-    {
-      ExoIconViewItem *item = items->data;
+  /* there is nothing to select in an empty view */
+  if (G_UNLIKELY (EXO_ICON_VIEW_N_ITEMS (icon_view) == 0))
+    return;
 
-      if (!item->selected)
-        {
-          dirty = TRUE;
-          item->selected = TRUE;
-          exo_icon_view_queue_draw_item (icon_view, item);
-        }
-    }
+  /* check if any item is not selected yet */
+  if (exo_icon_view_selection_contains_range (&icon_view->priv->selection, 0, EXO_ICON_VIEW_N_ITEMS (icon_view)))
+    return;
 
-  if (dirty)
-    g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+  exo_icon_view_selection_reset (&icon_view->priv->selection, TRUE);
+  gtk_widget_queue_draw (GTK_WIDGET (icon_view));
+
+  exo_icon_view_queue_selection_changed (icon_view);
 }
 
 
@@ -5884,27 +8857,19 @@ exo_icon_view_select_all (ExoIconView *icon_view)
 void
 exo_icon_view_selection_invert (ExoIconView *icon_view)
 {
-  GList           *items;
-  gboolean         dirty = FALSE;
-  ExoIconViewItem *item;
-
   g_return_if_fail (EXO_IS_ICON_VIEW (icon_view));
 
   if (icon_view->priv->selection_mode != GTK_SELECTION_MULTIPLE)
     return;
 
-  for (items = icon_view->priv->items; items; items = items->next)
+  if (EXO_ICON_VIEW_N_ITEMS (icon_view) > 0)
     {
-      item = items->data;
-
-      item->selected = !item->selected;
-      exo_icon_view_queue_draw_item (icon_view, item);
+      /* the ranges now describe the other items */
+      icon_view->priv->selection.inverted = !icon_view->priv->selection.inverted;
+      gtk_widget_queue_draw (GTK_WIDGET (icon_view));
 
-      dirty = TRUE;
+      exo_icon_view_queue_selection_changed (icon_view);
     }
-
-  if (dirty)
-    g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
 }
 
 
@@ -5924,7 +8889,7 @@ exo_icon_view_unselect_all (ExoIconView *icon_view)
     return;
 
   if (exo_icon_view_unselect_all_internal (icon_view))
-    g_signal_emit (icon_view, icon_view_signals[SELECTION_CHANGED], 0);
+    exo_icon_view_queue_selection_changed (icon_view);
 }
 
 
@@ -5949,9 +8914,9 @@ exo_icon_view_path_is_selected (const ExoIconView *icon_view,
   g_return_val_if_fail (icon_view->priv->model != NULL, FALSE);
   g_return_val_if_fail (gtk_tree_path_get_depth (path) > 0, FALSE);
 
-  item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices(path)[0]);
+  item = exo_icon_view_get_item_for_path (icon_view, path);
 
-  return (item != NULL && item->selected);
+  return (item != NULL && EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item));
 }
 
 
@@ -5997,7 +8962,7 @@ exo_icon_view_get_item_column (ExoIconView *icon_view,
   g_return_val_if_fail (icon_view->priv->model != NULL, -1);
   g_return_val_if_fail (gtk_tree_path_get_depth (path) > 0, -1);
 
-  item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices(path)[0]);
+  item = exo_icon_view_get_item_for_path (icon_view, path);
   if (G_LIKELY (item != NULL))
     return item->col;
 
@@ -6028,7 +8993,7 @@ exo_icon_view_get_item_row (ExoIconView *icon_view,
   g_return_val_if_fail (icon_view->priv->model != NULL, -1);
   g_return_val_if_fail (gtk_tree_path_get_depth (path) > 0, -1);
 
-  item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices(path)[0]);
+  item = exo_icon_view_get_item_for_path (icon_view, path);
   if (G_LIKELY (item != NULL))
     return item->row;
 
@@ -6067,7 +9032,7 @@ exo_icon_view_get_cursor (const ExoIconView *icon_view,
   info = (icon_view->priv->cursor_cell < 0) ? NULL : g_list_nth_data (icon_view->priv->cell_list, icon_view->priv->cursor_cell);
 
   if (G_LIKELY (path != NULL))
-    *path = (item != NULL) ? gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1) : NULL;
+    *path = (item != NULL) ? gtk_tree_path_new_from_indices (item->index, -1) : NULL;
 
   if (G_LIKELY (cell != NULL))
     *cell = (info != NULL) ? info->cell : NULL;
@@ -6113,7 +9078,7 @@ exo_icon_view_set_cursor (ExoIconView     *icon_view,
 
   exo_icon_view_stop_editing (icon_view, TRUE);
 
-  item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices(path)[0]);
+  item = exo_icon_view_get_item_for_path (icon_view, path);
   if (G_UNLIKELY (item == NULL))
     return;
 
@@ -6203,7 +9168,7 @@ exo_icon_view_scroll_to_path (ExoIconView *icon_view,
     }
   else
     {
-      item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices(path)[0]);
+      item = exo_icon_view_get_item_for_path (icon_view, path);
       if (G_UNLIKELY (item == NULL))
         return;
 
@@ -6283,10 +9248,6 @@ exo_icon_view_set_orientation (ExoIconView   *icon_view,
       icon_view->priv->orientation = orientation;
 
       exo_icon_view_stop_editing (icon_view, TRUE);
-      exo_icon_view_invalidate_sizes (icon_view);
-
-      update_text_cell (icon_view);
-      update_pixbuf_cell (icon_view);
 
       g_object_notify (G_OBJECT (icon_view), "orientation");
     }
@@ -6383,9 +9344,6 @@ exo_icon_view_set_item_width (ExoIconView *icon_view,
       icon_view->priv->item_width = item_width;
 
       exo_icon_view_stop_editing (icon_view, TRUE);
-      exo_icon_view_invalidate_sizes (icon_view);
-
-      update_text_cell (icon_view);
 
       g_object_notify (G_OBJECT (icon_view), "item-width");
     }
@@ -6393,6 +9351,64 @@ exo_icon_view_set_item_width (ExoIconView *icon_view,
 
 
 
+/**
+ * exo_icon_view_get_fixed_item_size:
+ * @icon_view : a #ExoIconView.
+ *
+ * Returns whether @icon_view assumes that all items have the same size.
+ *
+ * Returns: %TRUE if the ::fixed-item-size property is set.
+ *
+ * Since: 4.16
+ **/
+gboolean
+exo_icon_view_get_fixed_item_size (const ExoIconView *icon_view)
+{
+  g_return_val_if_fail (EXO_IS_ICON_VIEW (icon_view), FALSE);
+  return icon_view->priv->fixed_item_size;
+}
+
+
+
+/**
+ * exo_icon_view_set_fixed_item_size:
+ * @icon_view       : a #ExoIconView.
+ * @fixed_item_size : %TRUE to enable fixed item size mode.
+ *
+ * Enables or disables the fixed item size mode of @icon_view. In this
+ * mode, the size of the items is estimated from a sample of the items,
+ * and the cells of an item are only measured once the item becomes
+ * visible, which makes loading large models considerably faster. The
+ * per-row state is also only allocated for rows that are shown or
+ * otherwise needed, so large models take little memory. Only
+ * enable this mode if all items have the same size, like for a view
+ * with a fixed icon size and a fixed text wrap width.
+ *
+ * Since: 4.16
+ **/
+void
+exo_icon_view_set_fixed_item_size (ExoIconView *icon_view,
+                                   gboolean     fixed_item_size)
+{
+  g_return_if_fail (EXO_IS_ICON_VIEW (icon_view));
+
+  /* normalize the value */
+  fixed_item_size = !!fixed_item_size;
+
+  /* check if we have a new setting here */
+  if (icon_view->priv->fixed_item_size != fixed_item_size)
+    {
+      icon_view->priv->fixed_item_size = fixed_item_size;
+
+      exo_icon_view_stop_editing (icon_view, TRUE);
+      exo_icon_view_invalidate_sizes (icon_view);
+
+      g_object_notify (G_OBJECT (icon_view), "fixed-item-size");
+    }
+}
+
+
+
 /**
  * exo_icon_view_get_spacing:
  * @icon_view: a #ExoIconView
@@ -6434,7 +9450,6 @@ exo_icon_view_set_spacing (ExoIconView *icon_view,
       icon_view->priv->spacing = spacing;
 
       exo_icon_view_stop_editing (icon_view, TRUE);
-      exo_icon_view_invalidate_sizes (icon_view);
 
       g_object_notify (G_OBJECT (icon_view), "spacing");
     }
@@ -6482,7 +9497,6 @@ exo_icon_view_set_row_spacing (ExoIconView *icon_view,
       icon_view->priv->row_spacing = row_spacing;
 
       exo_icon_view_stop_editing (icon_view, TRUE);
-      exo_icon_view_invalidate_sizes (icon_view);
 
       g_object_notify (G_OBJECT (icon_view), "row-spacing");
     }
@@ -6530,7 +9544,6 @@ exo_icon_view_set_column_spacing (ExoIconView *icon_view,
       icon_view->priv->column_spacing = column_spacing;
 
       exo_icon_view_stop_editing (icon_view, TRUE);
-      exo_icon_view_invalidate_sizes (icon_view);
 
       g_object_notify (G_OBJECT (icon_view), "column-spacing");
     }
@@ -6579,7 +9592,6 @@ exo_icon_view_set_margin (ExoIconView *icon_view,
       icon_view->priv->margin = margin;
 
       exo_icon_view_stop_editing (icon_view, TRUE);
-      exo_icon_view_invalidate_sizes (icon_view);
 
       g_object_notify (G_OBJECT (icon_view), "margin");
     }
@@ -7072,7 +10084,7 @@ exo_icon_view_drag_begin (GtkWidget      *widget,
 
   _exo_return_if_fail (item != NULL);
 
-  path = gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1);
+  path = gtk_tree_path_new_from_indices (item->index, -1);
   icon = exo_icon_view_create_drag_icon (icon_view, path);
   gtk_tree_path_free (path);
 
@@ -7545,7 +10557,7 @@ exo_icon_view_set_drag_dest_item (ExoIconView            *icon_view,
       if (G_LIKELY (previous_path != NULL))
         {
           /* schedule a redraw for the previous path */
-          item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices (previous_path)[0]);
+          item = exo_icon_view_get_item_for_path (icon_view, previous_path);
           if (G_LIKELY (item != NULL))
             exo_icon_view_queue_draw_item (icon_view, item);
           gtk_tree_path_free (previous_path);
@@ -7576,7 +10588,7 @@ exo_icon_view_set_drag_dest_item (ExoIconView            *icon_view,
       icon_view->priv->dest_item = gtk_tree_row_reference_new_proxy (G_OBJECT (icon_view), icon_view->priv->model, path);
 
       /* schedule a redraw on the new path */
-      item = g_list_nth_data (icon_view->priv->items, gtk_tree_path_get_indices (path)[0]);
+      item = exo_icon_view_get_item_for_path (icon_view, path);
       if (G_LIKELY (item != NULL))
         exo_icon_view_queue_draw_item (icon_view, item);
     }
@@ -7660,7 +10672,7 @@ exo_icon_view_get_dest_item_at_pos (ExoIconView              *icon_view,
     return FALSE;
 
   if (G_LIKELY (path != NULL))
-    *path = gtk_tree_path_new_from_indices (g_list_index (icon_view->priv->items, item), -1);
+    *path = gtk_tree_path_new_from_indices (item->index, -1);
 
   if (G_LIKELY (pos != NULL))
     {
@@ -7697,10 +10709,9 @@ cairo_surface_t*
 exo_icon_view_create_drag_icon (ExoIconView *icon_view,
                                 GtkTreePath *path)
 {
+  GtkStyleContext *context;
   cairo_surface_t *surface;
   cairo_t         *cr;
-  GList           *lp;
-  gint             idx;
   ExoIconViewItem *item;
 
   g_return_val_if_fail (EXO_IS_ICON_VIEW (icon_view), NULL);
@@ -7710,30 +10721,28 @@ exo_icon_view_create_drag_icon (ExoIconView *icon_view,
   if (G_UNLIKELY (!gtk_widget_get_realized (GTK_WIDGET (icon_view))))
     return NULL;
 
-  idx = gtk_tree_path_get_indices (path)[0];
-
-  for (lp = icon_view->priv->items; lp != NULL; lp = lp->next)
-    {
-      item = lp->data;
-      if (G_UNLIKELY (idx == g_list_index (icon_view->priv->items, item)))
-        {
-          surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
-                                                item->area.width + 2,
-                                                item->area.height + 2);
+  /* lookup the item for the path */
+  item = exo_icon_view_get_item_for_path (icon_view, path);
+  if (G_UNLIKELY (item == NULL))
+    return NULL;
 
-          cr = cairo_create (surface);
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                        item->area.width + 2,
+                                        item->area.height + 2);
 
-          /* TODO: background / rectangles */
+  cr = cairo_create (surface);
 
-          exo_icon_view_paint_item (icon_view, item, cr, 1, 1, FALSE);
+  /* TODO: background / rectangles */
 
-          cairo_destroy (cr);
+  context = gtk_widget_get_style_context (GTK_WIDGET (icon_view));
+  gtk_style_context_save (context);
+  gtk_style_context_add_class (context, GTK_STYLE_CLASS_CELL);
+  exo_icon_view_paint_item (icon_view, item, cr, 1, 1, FALSE);
+  gtk_style_context_restore (context);
 
-          return surface;
-        }
-    }
+  cairo_destroy (cr);
 
-  return NULL;
+  return surface;
 }
 
 
@@ -8012,18 +11021,18 @@ exo_icon_view_single_click_timeout (gpointer user_data)
       else
         {
           if ((icon_view->priv->selection_mode == GTK_SELECTION_MULTIPLE ||
-              ((icon_view->priv->selection_mode == GTK_SELECTION_SINGLE) && item->selected)) &&
+              ((icon_view->priv->selection_mode == GTK_SELECTION_SINGLE) && EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item))) &&
               (icon_view->priv->single_click_timeout_state & GDK_CONTROL_MASK) != 0)
             {
-              item->selected = !item->selected;
+              exo_icon_view_set_item_selected (icon_view, item, !EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item));
               exo_icon_view_queue_draw_item (icon_view, item);
               dirty = TRUE;
             }
-          else if (!item->selected)
+          else if (!EXO_ICON_VIEW_ITEM_SELECTED (icon_view, item))
             {
               exo_icon_view_unselect_all_internal (icon_view);
               exo_icon_view_queue_draw_item (icon_view, item);
-              item->selected = TRUE;
+              exo_icon_view_set_item_selected (icon_view, item, TRUE);
               dirty = TRUE;
             }
           exo_icon_view_set_cursor_item (icon_view, item, -1);
@@ -8040,7 +11049,7 @@ exo_icon_view_single_click_timeout (gpointer user_data)
       EXO_ICON_VIEW_UNSET_FLAG (icon_view, EXO_ICON_VIEW_DRAW_KEYFOCUS);
 
       /* emit "selection-changed" */
-      g_signal_emit (G_OBJECT (icon_view), icon_view_signals[SELECTION_CHANGED], 0);
+      exo_icon_view_queue_selection_changed (icon_view);
     }
 
   return FALSE;
@@ -8154,6 +11163,7 @@ exo_icon_view_set_search_column (ExoIconView *icon_view,
   if (G_LIKELY (icon_view->priv->search_column != search_column))
     {
       icon_view->priv->search_column = search_column;
+      exo_icon_view_search_index_drop (icon_view);
       g_object_notify (G_OBJECT (icon_view), "search-column");
     }
 }
@@ -8268,6 +11278,34 @@ exo_icon_view_set_search_position_func (ExoIconView                  *icon_view,
 
 
 
+/**
+ * exo_icon_view_get_text_cache_stats:
+ * @icon_view : a #ExoIconView.
+ * @hits      : return location for the number of cache hits or %NULL.
+ * @misses    : return location for the number of cache misses or %NULL.
+ *
+ * Returns the number of hits and misses of the cache that remembers the
+ * measured sizes of the text cells in @icon_view. Only text bound to a
+ * model column is cached, cells with a cell data function are always
+ * measured again.
+ *
+ * Since: 4.16
+ **/
+void
+exo_icon_view_get_text_cache_stats (const ExoIconView *icon_view,
+                                    guint             *hits,
+                                    guint             *misses)
+{
+  g_return_if_fail (EXO_IS_ICON_VIEW (icon_view));
+
+  if (hits != NULL)
+    *hits = icon_view->priv->text_extents_hits;
+  if (misses != NULL)
+    *misses = icon_view->priv->text_extents_lookups - icon_view->priv->text_extents_hits;
+}
+
+
+
 static void
 exo_icon_view_search_activate (GtkEntry    *entry,
                                ExoIconView *icon_view)
@@ -8310,6 +11348,13 @@ exo_icon_view_search_dialog_hide (GtkWidget   *search_dialog,
   if (icon_view->priv->search_timeout_id != 0)
     g_source_remove (icon_view->priv->search_timeout_id);
 
+  /* cancel any running search */
+  exo_icon_view_search_slice_cancel (icon_view);
+
+  /* the index is rebuilt by the next search, so the model
+   * updates in between don't need to maintain it */
+  exo_icon_view_search_index_drop (icon_view);
+
   /* send focus-out event */
   _exo_gtk_widget_send_focus_change (icon_view->priv->search_entry, FALSE);
   gtk_widget_hide (search_dialog);
@@ -8392,6 +11437,9 @@ exo_icon_view_search_init (GtkWidget   *search_entry,
   _exo_return_if_fail (GTK_IS_ENTRY (search_entry));
   _exo_return_if_fail (EXO_IS_ICON_VIEW (icon_view));
 
+  /* the search for the previous text is stale now */
+  exo_icon_view_search_slice_cancel (icon_view);
+
   /* determine the current text for the search entry */
   text = gtk_entry_get_text (GTK_ENTRY (search_entry));
   if (G_UNLIKELY (text == NULL))
@@ -8422,6 +11470,13 @@ exo_icon_view_search_init (GtkWidget   *search_entry,
   if (G_UNLIKELY (model == NULL))
     return;
 
+  /* custom equal functions may be slow, so compare the rows in slices */
+  if (G_UNLIKELY (icon_view->priv->search_equal_func != exo_icon_view_search_equal_func))
+    {
+      exo_icon_view_search_slice_start (icon_view, text, 1);
+      return;
+    }
+
   /* start the interactive search */
   if (gtk_tree_model_get_iter_first (model, &iter))
     {
@@ -8442,11 +11497,33 @@ exo_icon_view_search_iter (ExoIconView  *icon_view,
                            gint          n)
 {
   GtkTreePath *path;
+  GArray      *matches;
 
   _exo_return_val_if_fail (EXO_IS_ICON_VIEW (icon_view), FALSE);
   _exo_return_val_if_fail (GTK_IS_TREE_MODEL (model), FALSE);
   _exo_return_val_if_fail (count != NULL, FALSE);
 
+  /* the default equal function is answered from the search index
+   * (the search always starts with the first row)
+   */
+  if (G_LIKELY (icon_view->priv->search_equal_func == exo_icon_view_search_equal_func))
+    {
+      matches = exo_icon_view_search_index_lookup (icon_view, text);
+      if (matches == NULL || *count + (gint) matches->len < n)
+        {
+          (*count) += (matches != NULL) ? matches->len : 0;
+          return FALSE;
+        }
+
+      /* place cursor on the item and select it */
+      path = gtk_tree_path_new_from_indices (g_array_index (matches, gint, n - *count - 1), -1);
+      exo_icon_view_select_path (icon_view, path);
+      exo_icon_view_set_cursor (icon_view, path, NULL, FALSE);
+      gtk_tree_path_free (path);
+      *count = n;
+      return TRUE;
+    }
+
   /* search for a matching item */
   do
     {
@@ -8498,6 +11575,16 @@ exo_icon_view_search_move (GtkWidget   *widget,
   if (G_UNLIKELY (length < 1))
     return;
 
+  /* custom equal functions are searched in slices, and the selection
+   * only changes once the match is found
+   */
+  if (G_UNLIKELY (icon_view->priv->search_equal_func != exo_icon_view_search_equal_func))
+    {
+      if (G_LIKELY (icon_view->priv->model != NULL))
+        exo_icon_view_search_slice_start (icon_view, text, icon_view->priv->search_selected_iter + (move_up ? -1 : 1));
+      return;
+    }
+
   /* unselect all items */
   exo_icon_view_unselect_all (icon_view);
 
@@ -8856,5 +11943,484 @@ exo_icon_view_search_timeout_destroy (gpointer user_data)
 
 
 
+static gchar*
+exo_icon_view_search_fold (const gchar *text)
+{
+  gchar *normalized;
+  gchar *folded;
+
+  /* same as exo_icon_view_search_equal_func() */
+  normalized = g_utf8_normalize (text, -1, G_NORMALIZE_ALL);
+  if (G_UNLIKELY (normalized == NULL))
+    return NULL;
+
+  folded = g_utf8_casefold (normalized, -1);
+  g_free (normalized);
+
+  return folded;
+}
+
+
+
+static gchar*
+exo_icon_view_search_key (GtkTreeModel *model,
+                          GtkTreeIter  *iter,
+                          gint          column)
+{
+  GValue  transformed = { 0, };
+  GValue  value = { 0, };
+  gchar  *key = NULL;
+
+  gtk_tree_model_get_value (model, iter, column, &value);
+
+  /* rows without a string never match */
+  g_value_init (&transformed, G_TYPE_STRING);
+  if (g_value_transform (&value, &transformed) && g_value_get_string (&transformed) != NULL)
+    key = exo_icon_view_search_fold (g_value_get_string (&transformed));
+
+  g_value_unset (&transformed);
+  g_value_unset (&value);
+
+  return key;
+}
+
+
+
+static gint
+exo_icon_view_search_compare_keys (gconstpointer a,
+                                   gconstpointer b,
+                                   gpointer      user_data)
+{
+  GPtrArray *keys = user_data;
+  gint       row_a = *((const gint *) a);
+  gint       row_b = *((const gint *) b);
+  gint       result;
+
+  /* sort by key, and rows with the same key by their position */
+  result = strcmp (g_ptr_array_index (keys, row_a), g_ptr_array_index (keys, row_b));
+  return (result != 0) ? result : (row_a - row_b);
+}
+
+
+
+static gint
+exo_icon_view_search_compare_rows (gconstpointer a,
+                                   gconstpointer b)
+{
+  return *((const gint *) a) - *((const gint *) b);
+}
+
+
+
+static void
+exo_icon_view_search_index_build (ExoIconView *icon_view)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  GtkTreeIter         iter;
+  gchar              *key;
+  gint                n_rows;
+  gint                row;
+
+  n_rows = (priv->model != NULL) ? gtk_tree_model_iter_n_children (priv->model, NULL) : 0;
+
+  priv->search_keys = g_ptr_array_new_full (n_rows, g_free);
+  priv->search_sorted = g_array_sized_new (FALSE, FALSE, sizeof (gint), n_rows);
+  priv->search_matches = g_array_new (FALSE, FALSE, sizeof (gint));
+
+  /* normalize the search column of every row once */
+  if (n_rows > 0 && gtk_tree_model_get_iter_first (priv->model, &iter))
+    {
+      for (row = 0;; ++row)
+        {
+          key = exo_icon_view_search_key (priv->model, &iter, priv->search_column);
+          g_ptr_array_add (priv->search_keys, key);
+          if (G_LIKELY (key != NULL))
+            g_array_append_val (priv->search_sorted, row);
+
+          if (!gtk_tree_model_iter_next (priv->model, &iter))
+            break;
+        }
+    }
+
+  g_array_sort_with_data (priv->search_sorted, exo_icon_view_search_compare_keys, priv->search_keys);
+}
+
+
+
+static void
+exo_icon_view_search_index_drop (ExoIconView *icon_view)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+
+  if (G_LIKELY (priv->search_keys == NULL))
+    return;
+
+  g_ptr_array_free (priv->search_keys, TRUE);
+  g_array_free (priv->search_sorted, TRUE);
+  g_array_free (priv->search_matches, TRUE);
+  g_free (priv->search_matches_key);
+
+  priv->search_keys = NULL;
+  priv->search_sorted = NULL;
+  priv->search_matches = NULL;
+  priv->search_matches_key = NULL;
+}
+
+
+
+static guint
+exo_icon_view_search_index_find (ExoIconView *icon_view,
+                                 const gchar *key,
+                                 gint         row)
+{
+  const gint *sorted = (const gint *) icon_view->priv->search_sorted->data;
+  guint       lower;
+  guint       upper;
+  guint       mid;
+  gint        result;
+
+  /* lookup the position of the row in the sorted rows */
+  for (lower = 0, upper = icon_view->priv->search_sorted->len; lower < upper; )
+    {
+      mid = (lower + upper) / 2;
+      result = strcmp (g_ptr_array_index (icon_view->priv->search_keys, sorted[mid]), key);
+      if (result < 0 || (result == 0 && sorted[mid] < row))
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+
+  return lower;
+}
+
+
+
+static void
+exo_icon_view_search_index_insert (ExoIconView *icon_view,
+                                   GtkTreeIter *iter,
+                                   gint         row)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  gchar              *key;
+  guint               n;
+
+  if (G_LIKELY (priv->search_keys == NULL))
+    return;
+
+  if (G_UNLIKELY (row > (gint) priv->search_keys->len))
+    {
+      exo_icon_view_search_index_drop (icon_view);
+      return;
+    }
+
+  /* move the following rows */
+  for (n = 0; n < priv->search_sorted->len; ++n)
+    if (g_array_index (priv->search_sorted, gint, n) >= row)
+      g_array_index (priv->search_sorted, gint, n) += 1;
+
+  key = exo_icon_view_search_key (priv->model, iter, priv->search_column);
+  g_ptr_array_insert (priv->search_keys, row, key);
+  if (G_LIKELY (key != NULL))
+    g_array_insert_val (priv->search_sorted, exo_icon_view_search_index_find (icon_view, key, row), row);
+
+  /* the matches must be looked up again */
+  g_free (priv->search_matches_key);
+  priv->search_matches_key = NULL;
+}
+
+
+
+static void
+exo_icon_view_search_index_delete (ExoIconView *icon_view,
+                                   gint         row)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  const gchar        *key;
+  guint               n;
+
+  if (G_LIKELY (priv->search_keys == NULL))
+    return;
+
+  if (G_UNLIKELY (row >= (gint) priv->search_keys->len))
+    {
+      exo_icon_view_search_index_drop (icon_view);
+      return;
+    }
+
+  key = g_ptr_array_index (priv->search_keys, row);
+  if (G_LIKELY (key != NULL))
+    g_array_remove_index (priv->search_sorted, exo_icon_view_search_index_find (icon_view, key, row));
+  g_ptr_array_remove_index (priv->search_keys, row);
+
+  /* move the following rows */
+  for (n = 0; n < priv->search_sorted->len; ++n)
+    if (g_array_index (priv->search_sorted, gint, n) > row)
+      g_array_index (priv->search_sorted, gint, n) -= 1;
+
+  /* the matches must be looked up again */
+  g_free (priv->search_matches_key);
+  priv->search_matches_key = NULL;
+}
+
+
+
+static void
+exo_icon_view_search_index_changed (ExoIconView *icon_view,
+                                    GtkTreeIter *iter,
+                                    gint         row)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  gchar              *old_key;
+  gchar              *key;
+
+  if (G_LIKELY (priv->search_keys == NULL))
+    return;
+
+  if (G_UNLIKELY (row >= (gint) priv->search_keys->len))
+    {
+      exo_icon_view_search_index_drop (icon_view);
+      return;
+    }
+
+  /* most changes don't affect the search column */
+  key = exo_icon_view_search_key (priv->model, iter, priv->search_column);
+  old_key = g_ptr_array_index (priv->search_keys, row);
+  if (G_LIKELY (g_strcmp0 (old_key, key) == 0))
+    {
+      g_free (key);
+      return;
+    }
+
+  if (old_key != NULL)
+    g_array_remove_index (priv->search_sorted, exo_icon_view_search_index_find (icon_view, old_key, row));
+
+  g_ptr_array_index (priv->search_keys, row) = key;
+  g_free (old_key);
+
+  if (key != NULL)
+    g_array_insert_val (priv->search_sorted, exo_icon_view_search_index_find (icon_view, key, row), row);
+
+  /* the matches must be looked up again */
+  g_free (priv->search_matches_key);
+  priv->search_matches_key = NULL;
+}
+
+
+
+static void
+exo_icon_view_search_index_reorder (ExoIconView *icon_view,
+                                    gint         length,
+                                    const gint  *new_order)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  GPtrArray          *keys;
+  gint               *position;
+  guint               n;
+
+  if (G_LIKELY (priv->search_keys == NULL))
+    return;
+
+  if (G_UNLIKELY (length != (gint) priv->search_keys->len))
+    {
+      exo_icon_view_search_index_drop (icon_view);
+      return;
+    }
+
+  /* new_order[n] is the former position of the row now at position n */
+  keys = g_ptr_array_new_full (length, g_free);
+  position = g_new (gint, length);
+  for (n = 0; n < (guint) length; ++n)
+    {
+      position[new_order[n]] = n;
+      g_ptr_array_add (keys, g_ptr_array_index (priv->search_keys, new_order[n]));
+    }
+
+  /* the keys moved to the new array */
+  g_ptr_array_set_free_func (priv->search_keys, NULL);
+  g_ptr_array_free (priv->search_keys, TRUE);
+  priv->search_keys = keys;
+
+  /* rows with the same key are sorted by their position */
+  for (n = 0; n < priv->search_sorted->len; ++n)
+    g_array_index (priv->search_sorted, gint, n) = position[g_array_index (priv->search_sorted, gint, n)];
+  g_array_sort_with_data (priv->search_sorted, exo_icon_view_search_compare_keys, priv->search_keys);
+  g_free (position);
+
+  /* the matches must be looked up again */
+  g_free (priv->search_matches_key);
+  priv->search_matches_key = NULL;
+}
+
+
+
+static GArray*
+exo_icon_view_search_index_lookup (ExoIconView *icon_view,
+                                   const gchar *text)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+  const gint         *sorted;
+  gchar              *key;
+  gsize               length;
+  guint               first;
+  guint               lower;
+  guint               upper;
+  guint               mid;
+  guint               n;
+  gint               *matches;
+
+  key = exo_icon_view_search_fold (text);
+  if (G_UNLIKELY (key == NULL))
+    return NULL;
+
+  if (G_UNLIKELY (priv->search_keys == NULL))
+    exo_icon_view_search_index_build (icon_view);
+
+  /* moving to the next or previous match searches for the same key again */
+  if (priv->search_matches_key != NULL && strcmp (priv->search_matches_key, key) == 0)
+    {
+      g_free (key);
+      return priv->search_matches;
+    }
+
+  /* when the key grows while typing, only the previous matches can still match */
+  length = strlen (key);
+  if (priv->search_matches_key != NULL && strncmp (key, priv->search_matches_key, strlen (priv->search_matches_key)) == 0)
+    {
+      matches = (gint *) priv->search_matches->data;
+      for (lower = n = 0; n < priv->search_matches->len; ++n)
+        if (strncmp (g_ptr_array_index (priv->search_keys, matches[n]), key, length) == 0)
+          matches[lower++] = matches[n];
+      g_array_set_size (priv->search_matches, lower);
+
+      g_free (priv->search_matches_key);
+      priv->search_matches_key = key;
+
+      return priv->search_matches;
+    }
+
+  /* lookup the first row with a key not below the search key */
+  sorted = (const gint *) priv->search_sorted->data;
+  for (lower = 0, upper = priv->search_sorted->len; lower < upper; )
+    {
+      mid = (lower + upper) / 2;
+      if (strcmp (g_ptr_array_index (priv->search_keys, sorted[mid]), key) < 0)
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+
+  /* the rows starting with the search key follow */
+  for (first = lower, upper = priv->search_sorted->len; lower < upper; )
+    {
+      mid = (lower + upper) / 2;
+      if (strncmp (g_ptr_array_index (priv->search_keys, sorted[mid]), key, length) == 0)
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+
+  /* the matches are visited in model order */
+  g_array_set_size (priv->search_matches, 0);
+  g_array_append_vals (priv->search_matches, sorted + first, lower - first);
+  g_array_sort (priv->search_matches, exo_icon_view_search_compare_rows);
+
+  g_free (priv->search_matches_key);
+  priv->search_matches_key = key;
+
+  return priv->search_matches;
+}
+
+
+
+static void
+exo_icon_view_search_slice_start (ExoIconView *icon_view,
+                                  const gchar *text,
+                                  gint         n)
+{
+  ExoIconViewPrivate *priv = icon_view->priv;
+
+  /* the previous search is stale */
+  exo_icon_view_search_slice_cancel (icon_view);
+
+  priv->search_slice_text = g_strdup (text);
+  priv->search_slice_n = n;
+  priv->search_slice_count = 0;
+  priv->search_slice_row = 0;
+
+  /* run the first slice right away, which is enough for small models */
+  if (exo_icon_view_search_slice (icon_view))
+    {
+      priv->search_slice_id = gdk_threads_add_idle_full (G_PRIORITY_DEFAULT_IDLE, exo_icon_view_search_slice,
+                                                         icon_view, exo_icon_view_search_slice_destroy);
+    }
+}
+
+
+
+static void
+exo_icon_view_search_slice_cancel (ExoIconView *icon_view)
+{
+  if (G_UNLIKELY (icon_view->priv->search_slice_id != 0))
+    g_source_remove (icon_view->priv->search_slice_id);
+
+  g_free (icon_view->priv->search_slice_text);
+  icon_view->priv->search_slice_text = NULL;
+}
+
+
+
+static gboolean
+exo_icon_view_search_slice (gpointer user_data)
+{
+  ExoIconView        *icon_view = EXO_ICON_VIEW (user_data);
+  ExoIconViewPrivate *priv = icon_view->priv;
+  GtkTreePath        *path;
+  GtkTreeIter         iter;
+  gboolean            valid;
+  gint64              deadline;
+
+  deadline = g_get_monotonic_time () + EXO_ICON_VIEW_SEARCH_SLICE_TIME;
+
+  /* continue with the next row, the iterators may not persist */
+  valid = (priv->model != NULL && gtk_tree_model_iter_nth_child (priv->model, &iter, NULL, priv->search_slice_row));
+  for (; valid; valid = gtk_tree_model_iter_next (priv->model, &iter))
+    {
+      /* continue in the next main loop iteration when the time is up */
+      if (G_UNLIKELY (g_get_monotonic_time () >= deadline))
+        return TRUE;
+
+      priv->search_slice_row += 1;
+      if ((*priv->search_equal_func) (priv->model, priv->search_column, priv->search_slice_text, &iter, priv->search_equal_data))
+        continue;
+
+      priv->search_slice_count += 1;
+      if (priv->search_slice_count == priv->search_slice_n)
+        {
+          /* place cursor on the item and select it */
+          path = gtk_tree_path_new_from_indices (priv->search_slice_row - 1, -1);
+          exo_icon_view_unselect_all (icon_view);
+          exo_icon_view_select_path (icon_view, path);
+          exo_icon_view_set_cursor (icon_view, path, NULL, FALSE);
+          gtk_tree_path_free (path);
+
+          priv->search_selected_iter = priv->search_slice_n;
+          break;
+        }
+    }
+
+  /* the search is done, with or without a match */
+  return FALSE;
+}
+
+
+
+static void
+exo_icon_view_search_slice_destroy (gpointer user_data)
+{
+  EXO_ICON_VIEW (user_data)->priv->search_slice_id = 0;
+}
+
+
+
 #define __EXO_ICON_VIEW_C__
 #include <exo/exo-aliasdef.c>
@@ -190,6 +190,9 @@ GtkTreeModel         *exo_icon_view_get_model                 (const ExoIconView
 void                  exo_icon_view_set_model                 (ExoIconView              *icon_view,
                                                                GtkTreeModel             *model);
 
+void                  exo_icon_view_freeze_updates            (ExoIconView              *icon_view);
+void                  exo_icon_view_thaw_updates              (ExoIconView              *icon_view);
+
 GtkOrientation        exo_icon_view_get_orientation           (const ExoIconView        *icon_view);
 void                  exo_icon_view_set_orientation           (ExoIconView              *icon_view,
                                                                GtkOrientation            orientation);
@@ -202,6 +205,10 @@ gint                  exo_icon_view_get_item_width            (const ExoIconView
 void                  exo_icon_view_set_item_width            (ExoIconView              *icon_view,
                                                                gint                      item_width);
 
+gboolean              exo_icon_view_get_fixed_item_size       (const ExoIconView        *icon_view);
+void                  exo_icon_view_set_fixed_item_size       (ExoIconView              *icon_view,
+                                                               gboolean                  fixed_item_size);
+
 gint                  exo_icon_view_get_spacing               (const ExoIconView        *icon_view);
 void                  exo_icon_view_set_spacing               (ExoIconView              *icon_view,
                                                                gint                      spacing);
@@ -344,6 +351,11 @@ void                          exo_icon_view_set_search_position_func  (ExoIconVi
                                                                        gpointer                      search_position_data,
                                                                        GDestroyNotify                search_position_destroy);
 
+/* Cache statistics */
+void                          exo_icon_view_get_text_cache_stats      (const ExoIconView            *icon_view,
+                                                                       guint                        *hits,
+                                                                       guint                        *misses);
+
 G_END_DECLS
 
 #endif /* __EXO_ICON_VIEW_H__ */
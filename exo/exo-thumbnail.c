@@ -65,15 +65,69 @@
 
 
 
-static GdkPixbuf *exo_thumbnail_load (const gchar *thumbnail_path,
-                                      const gchar *uri,
-                                      time_t       mtime,
-                                      GError     **error) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;;
-static gboolean   exo_thumbnail_save (GdkPixbuf   *thumbnail,
-                                      const gchar *thumbnail_path,
-                                      const gchar *uri,
-                                      time_t       mtime,
-                                      GError     **error);
+/* the maximum number of entries in the cache for each thumbnail size */
+#define EXO_THUMBNAIL_CACHE_SIZE (128)
+
+
+
+typedef struct _ExoThumbnailCache      ExoThumbnailCache;
+typedef struct _ExoThumbnailCacheEntry ExoThumbnailCacheEntry;
+
+
+
+static GdkPixbuf *exo_thumbnail_load         (const gchar      *thumbnail_path,
+                                              const gchar      *uri,
+                                              time_t            mtime,
+                                              GError          **error) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;;
+static gboolean   exo_thumbnail_save         (GdkPixbuf        *thumbnail,
+                                              const gchar      *thumbnail_path,
+                                              const gchar      *uri,
+                                              time_t            mtime,
+                                              GError          **error);
+static gchar     *exo_thumbnail_get_path     (const gchar      *uri,
+                                              ExoThumbnailSize  size) G_GNUC_MALLOC;
+static gboolean   exo_thumbnail_cache_lookup (const gchar      *key,
+                                              ExoThumbnailSize  size,
+                                              gchar           **uri_return,
+                                              gchar           **path_return,
+                                              time_t           *mtime_return,
+                                              GdkPixbuf       **thumbnail_return);
+static void       exo_thumbnail_cache_store  (const gchar      *key,
+                                              ExoThumbnailSize  size,
+                                              const gchar      *uri,
+                                              const gchar      *path,
+                                              time_t            mtime,
+                                              GdkPixbuf        *thumbnail);
+
+
+
+struct _ExoThumbnailCache
+{
+  GHashTable *entries;
+  GQueue      lru;
+};
+
+struct _ExoThumbnailCacheEntry
+{
+  gchar     *key;
+  gchar     *uri;
+  gchar     *path;
+
+  /* the last loaded thumbnail and the mtime it was validated for */
+  GdkPixbuf *thumbnail;
+  time_t     mtime;
+
+  GList      lru_link;
+};
+
+
+
+/* the thumbnail paths and the last loaded thumbnails for the normal and
+ * large sizes, keyed by filename or URI. The icon renderer loads thumbnails
+ * in worker threads, so the caches are protected by a mutex.
+ */
+static ExoThumbnailCache thumbnail_caches[2];
+static GMutex            thumbnail_caches_mutex;
 
 
 
@@ -172,6 +226,139 @@ exo_thumbnail_save (GdkPixbuf   *thumbnail,
 
 
 
+static gchar*
+exo_thumbnail_get_path (const gchar     *uri,
+                        ExoThumbnailSize size)
+{
+  gchar *name;
+  gchar *path;
+  gchar *md5;
+
+  /* determine the filename of the thumbnail */
+  md5 = g_compute_checksum_for_string (G_CHECKSUM_MD5, uri, -1);
+  name = g_strconcat (md5, ".png", NULL);
+  g_free (md5);
+
+  /* determine the path of the thumbnail */
+  path = g_build_path ("/", g_get_user_cache_dir(), "thumbnails", (size == EXO_THUMBNAIL_SIZE_NORMAL) ? "normal" : "large", name, NULL);
+  g_free (name);
+
+  return path;
+}
+
+
+
+static void
+exo_thumbnail_cache_entry_free (gpointer data)
+{
+  ExoThumbnailCacheEntry *entry = data;
+
+  if (entry->thumbnail != NULL)
+    g_object_unref (G_OBJECT (entry->thumbnail));
+  g_free (entry->path);
+  g_free (entry->uri);
+  g_free (entry->key);
+  g_slice_free (ExoThumbnailCacheEntry, entry);
+}
+
+
+
+static ExoThumbnailCache*
+exo_thumbnail_cache_get (ExoThumbnailSize size)
+{
+  ExoThumbnailCache *cache;
+
+  cache = thumbnail_caches + ((size == EXO_THUMBNAIL_SIZE_NORMAL) ? 0 : 1);
+  if (G_UNLIKELY (cache->entries == NULL))
+    cache->entries = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, exo_thumbnail_cache_entry_free);
+
+  return cache;
+}
+
+
+
+static gboolean
+exo_thumbnail_cache_lookup (const gchar      *key,
+                            ExoThumbnailSize  size,
+                            gchar           **uri_return,
+                            gchar           **path_return,
+                            time_t           *mtime_return,
+                            GdkPixbuf       **thumbnail_return)
+{
+  ExoThumbnailCacheEntry *entry;
+  ExoThumbnailCache      *cache;
+
+  g_mutex_lock (&thumbnail_caches_mutex);
+
+  cache = exo_thumbnail_cache_get (size);
+  entry = g_hash_table_lookup (cache->entries, key);
+  if (G_LIKELY (entry != NULL))
+    {
+      /* move the entry to the front of the LRU list */
+      g_queue_unlink (&cache->lru, &entry->lru_link);
+      g_queue_push_head_link (&cache->lru, &entry->lru_link);
+
+      if (uri_return != NULL)
+        *uri_return = g_strdup (entry->uri);
+      *path_return = g_strdup (entry->path);
+      *mtime_return = entry->mtime;
+      *thumbnail_return = (entry->thumbnail != NULL) ? g_object_ref (G_OBJECT (entry->thumbnail)) : NULL;
+    }
+
+  g_mutex_unlock (&thumbnail_caches_mutex);
+
+  return (entry != NULL);
+}
+
+
+
+static void
+exo_thumbnail_cache_store (const gchar      *key,
+                           ExoThumbnailSize  size,
+                           const gchar      *uri,
+                           const gchar      *path,
+                           time_t            mtime,
+                           GdkPixbuf        *thumbnail)
+{
+  ExoThumbnailCacheEntry *entry;
+  ExoThumbnailCache      *cache;
+  GList                  *lp;
+
+  g_mutex_lock (&thumbnail_caches_mutex);
+
+  cache = exo_thumbnail_cache_get (size);
+  entry = g_hash_table_lookup (cache->entries, key);
+  if (G_LIKELY (entry == NULL))
+    {
+      entry = g_slice_new0 (ExoThumbnailCacheEntry);
+      entry->key = g_strdup (key);
+      entry->uri = g_strdup (uri);
+      entry->path = g_strdup (path);
+      entry->lru_link.data = entry;
+      g_hash_table_insert (cache->entries, entry->key, entry);
+      g_queue_push_head_link (&cache->lru, &entry->lru_link);
+
+      /* drop the least recently used entries */
+      while (cache->lru.length > EXO_THUMBNAIL_CACHE_SIZE)
+        {
+          lp = g_queue_pop_tail_link (&cache->lru);
+          g_hash_table_remove (cache->entries, ((ExoThumbnailCacheEntry *) lp->data)->key);
+        }
+    }
+
+  /* remember the thumbnail for the mtime it was validated for */
+  if (G_LIKELY (thumbnail != NULL))
+    g_object_ref (G_OBJECT (thumbnail));
+  if (entry->thumbnail != NULL)
+    g_object_unref (G_OBJECT (entry->thumbnail));
+  entry->thumbnail = thumbnail;
+  entry->mtime = mtime;
+
+  g_mutex_unlock (&thumbnail_caches_mutex);
+}
+
+
+
 /**
  * _exo_thumbnail_get_for_file:
  * @filename : the absolute path to the file for which to load or generate a thumbnail.
@@ -193,9 +380,8 @@ _exo_thumbnail_get_for_file (const gchar     *filename,
   struct stat statb;
   GdkPixbuf  *thumbnail = NULL;
   GError     *err = NULL;
-  gchar      *name;
+  time_t      mtime;
   gchar      *path;
-  gchar      *md5;
   gchar      *uri;
 
   _exo_return_val_if_fail (size == EXO_THUMBNAIL_SIZE_NORMAL || size == EXO_THUMBNAIL_SIZE_LARGE, NULL);
@@ -207,46 +393,60 @@ _exo_thumbnail_get_for_file (const gchar     *filename,
     {
       /* we cannot recover from here */
       g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno), "%s", g_strerror (errno));
+      return NULL;
+    }
+
+  /* check if we already know the URI and thumbnail path of the file */
+  if (exo_thumbnail_cache_lookup (filename, size, &uri, &path, &mtime, &thumbnail))
+    {
+      /* the last loaded thumbnail is still valid if the file was not modified */
+      if (G_LIKELY (thumbnail != NULL && mtime == statb.st_mtime))
+        {
+          g_free (path);
+          g_free (uri);
+          return thumbnail;
+        }
+
+      if (thumbnail != NULL)
+        g_object_unref (G_OBJECT (thumbnail));
+      thumbnail = NULL;
     }
   else
     {
       /* determine the URI of the file */
       uri = g_filename_to_uri (filename, NULL, error);
-      if (G_LIKELY (uri != NULL))
+      if (G_UNLIKELY (uri == NULL))
+        return NULL;
+
+      /* determine the path of the thumbnail */
+      path = exo_thumbnail_get_path (uri, size);
+    }
+
+  /* try to load the thumbnail */
+  thumbnail = exo_thumbnail_load (path, uri, statb.st_mtime, NULL);
+  if (G_UNLIKELY (thumbnail == NULL))
+    {
+      /* try to generate a thumbnail for the file using the available GdkPixbufLoaders */
+      thumbnail = exo_gdk_pixbuf_new_from_file_at_max_size (filename, size, size, TRUE, error);
+      if (G_LIKELY (thumbnail != NULL))
         {
-          /* determine the filename of the thumbnail */
-          md5 = g_compute_checksum_for_string (G_CHECKSUM_MD5, uri, -1);
-          name = g_strconcat (md5, ".png", NULL);
-          g_free (md5);
-
-          /* determine the path of the thumbnail */
-          path = g_build_path ("/", g_get_user_cache_dir(), "thumbnails", (size == EXO_THUMBNAIL_SIZE_NORMAL) ? "normal" : "large", name, NULL);
-          g_free (name);
-
-          /* try to load the thumbnail */
-          thumbnail = exo_thumbnail_load (path, uri, statb.st_mtime, NULL);
-          if (G_UNLIKELY (thumbnail == NULL))
+          /* save the generated thumbnail into the thumbnail database */
+          if (!exo_thumbnail_save (thumbnail, path, uri, statb.st_mtime, &err))
             {
-              /* try to generate a thumbnail for the file using the available GdkPixbufLoaders */
-              thumbnail = exo_gdk_pixbuf_new_from_file_at_max_size (filename, size, size, TRUE, error);
-              if (G_LIKELY (thumbnail != NULL))
-                {
-                  /* save the generated thumbnail into the thumbnail database */
-                  if (!exo_thumbnail_save (thumbnail, path, uri, statb.st_mtime, &err))
-                    {
-                      /* better let the user know whats going on, but no need to fail here */
-                      g_warning ("Failed to save generated thumbnail for \"%s\" to \"%s\": %s", filename, path, err->message);
-                      g_error_free (err);
-                    }
-                }
+              /* better let the user know whats going on, but no need to fail here */
+              g_warning ("Failed to save generated thumbnail for \"%s\" to \"%s\": %s", filename, path, err->message);
+              g_error_free (err);
             }
-
-          /* cleanup */
-          g_free (path);
-          g_free (uri);
         }
     }
 
+  /* remember the paths and the thumbnail for the next time */
+  exo_thumbnail_cache_store (filename, size, uri, path, statb.st_mtime, thumbnail);
+
+  /* cleanup */
+  g_free (path);
+  g_free (uri);
+
   return thumbnail;
 }
 
@@ -268,26 +468,42 @@ _exo_thumbnail_get_for_uri (const gchar     *uri,
                             ExoThumbnailSize size,
                             GError         **error)
 {
-  GdkPixbuf *thumbnail;
-  gchar     *name;
-  gchar     *path;
-  gchar     *md5;
+  struct stat statb;
+  GdkPixbuf  *thumbnail = NULL;
+  time_t      mtime = (time_t) -1;
+  gchar      *path;
 
   _exo_return_val_if_fail (size == EXO_THUMBNAIL_SIZE_NORMAL || size == EXO_THUMBNAIL_SIZE_LARGE, NULL);
   _exo_return_val_if_fail (error == NULL || *error == NULL, NULL);
   _exo_return_val_if_fail (uri != NULL, NULL);
 
-  /* determine the filename of the thumbnail */
-  md5 = g_compute_checksum_for_string (G_CHECKSUM_MD5, uri, -1);
-  name = g_strconcat (md5, ".png", NULL);
-  g_free (md5);
+  /* determine the path of the thumbnail, unless we already know it */
+  if (!exo_thumbnail_cache_lookup (uri, size, NULL, &path, &mtime, &thumbnail))
+    path = exo_thumbnail_get_path (uri, size);
 
-  /* determine the path of the thumbnail */
-  path = g_build_path ("/", g_get_user_cache_dir(), "thumbnails", (size == EXO_THUMBNAIL_SIZE_NORMAL) ? "normal" : "large", name, NULL);
-  g_free (name);
+  /* the source mtime is unknown, so check if the thumbnail file itself changed */
+  if (G_LIKELY (stat (path, &statb) == 0))
+    {
+      if (G_LIKELY (thumbnail != NULL && mtime == statb.st_mtime))
+        {
+          g_free (path);
+          return thumbnail;
+        }
+      mtime = statb.st_mtime;
+    }
+  else
+    {
+      mtime = (time_t) -1;
+    }
+
+  if (thumbnail != NULL)
+    g_object_unref (G_OBJECT (thumbnail));
 
   /* try to load the thumbnail */
   thumbnail = exo_thumbnail_load (path, uri, (time_t) -1, error);
+
+  /* remember the path and the thumbnail for the next time */
+  exo_thumbnail_cache_store (uri, size, NULL, path, mtime, thumbnail);
   g_free (path);
 
   return thumbnail;
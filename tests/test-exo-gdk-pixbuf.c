@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2020 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <exo/exo.h>
+
+
+
+/* widths around the vector sizes of the SSE2 and AVX2 kernels */
+static const gint widths[] = { 1, 3, 4, 5, 7, 8, 9, 11, 15, 16, 17, 23, 31, 32, 33, 37, 64, 97 };
+
+/* the digest of the effects computed with the scalar kernels */
+static gchar *reference = NULL;
+
+
+
+static void
+checksum_pixbuf (GChecksum       *checksum,
+                 const GdkPixbuf *pixbuf)
+{
+  const guchar *pixels = gdk_pixbuf_get_pixels (pixbuf);
+  gint          n_bytes;
+  gint          i;
+
+  /* the padding at the end of the rows is not written */
+  n_bytes = gdk_pixbuf_get_width (pixbuf) * gdk_pixbuf_get_n_channels (pixbuf);
+  for (i = 0; i < gdk_pixbuf_get_height (pixbuf); ++i)
+    g_checksum_update (checksum, pixels + i * gdk_pixbuf_get_rowstride (pixbuf), n_bytes);
+}
+
+
+
+static GdkPixbuf *
+random_pixbuf (GRand   *rand,
+               gboolean has_alpha,
+               gint     width,
+               gint     height)
+{
+  GdkPixbuf *pixbuf;
+  guchar    *pixels;
+  gint       n_bytes;
+  gint       i, k;
+
+  pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, has_alpha, 8, width, height);
+  pixels = gdk_pixbuf_get_pixels (pixbuf);
+  n_bytes = width * gdk_pixbuf_get_n_channels (pixbuf);
+  for (i = 0; i < height; ++i)
+    for (k = 0; k < n_bytes; ++k)
+      pixels[i * gdk_pixbuf_get_rowstride (pixbuf) + k] = g_rand_int_range (rand, 0, 256);
+
+  return pixbuf;
+}
+
+
+
+static gchar *
+compute_digest (void)
+{
+  static const guint percents[] = { 0, 1, 33, 50, 99, 100 };
+  GdkPixbuf         *source;
+  GdkPixbuf         *result;
+  GChecksum         *checksum;
+  GdkColor           color;
+  guchar            *pixels;
+  gchar             *digest;
+  GRand             *rand;
+  guint              percent;
+  guint              n;
+  gint               has_alpha;
+  gint               j;
+
+  checksum = g_checksum_new (G_CHECKSUM_SHA256);
+  rand = g_rand_new_with_seed (20200101);
+
+  for (has_alpha = 0; has_alpha < 2; ++has_alpha)
+    for (n = 0; n < G_N_ELEMENTS (widths); ++n)
+      {
+        source = random_pixbuf (rand, has_alpha, widths[n], 3);
+
+        color.pixel = 0;
+        color.red = g_rand_int_range (rand, 0, 65536);
+        color.green = g_rand_int_range (rand, 0, 65536);
+        color.blue = g_rand_int_range (rand, 0, 65536);
+
+        result = exo_gdk_pixbuf_colorize (source, &color);
+        checksum_pixbuf (checksum, result);
+        g_object_unref (result);
+
+        result = exo_gdk_pixbuf_spotlight (source);
+        checksum_pixbuf (checksum, result);
+        g_object_unref (result);
+
+        for (j = 0; j < (gint) G_N_ELEMENTS (percents); ++j)
+          {
+            result = exo_gdk_pixbuf_lucent (source, percents[j]);
+            checksum_pixbuf (checksum, result);
+            g_object_unref (result);
+          }
+
+        /* all effects at once, adding an alpha channel to RGB sources */
+        result = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, widths[n], 3);
+        exo_gdk_pixbuf_apply_effects (source, result, EXO_GDK_PIXBUF_EFFECT_COLORIZE
+                                      | EXO_GDK_PIXBUF_EFFECT_SPOTLIGHT | EXO_GDK_PIXBUF_EFFECT_LUCENT,
+                                      &color, 50);
+        checksum_pixbuf (checksum, result);
+        g_object_unref (result);
+
+        g_object_unref (source);
+      }
+
+  /* every alpha value with every percentage, for the division by 100 */
+  source = random_pixbuf (rand, TRUE, 256, 1);
+  pixels = gdk_pixbuf_get_pixels (source);
+  for (j = 0; j < 256; ++j)
+    pixels[4 * j + 3] = j;
+  for (percent = 0; percent <= 100; ++percent)
+    {
+      result = exo_gdk_pixbuf_lucent (source, percent);
+      checksum_pixbuf (checksum, result);
+      g_object_unref (result);
+    }
+  g_object_unref (source);
+
+  digest = g_strdup (g_checksum_get_string (checksum));
+  g_checksum_free (checksum);
+  g_rand_free (rand);
+
+  return digest;
+}
+
+
+
+static void
+test_gdk_pixbuf_kernels (gconstpointer data)
+{
+  const gchar *kernels = data;
+  gboolean     supported;
+  gchar       *pattern;
+
+  /* the child prints the digest of the effects computed with the kernels */
+  if (g_test_subprocess ())
+    {
+      pattern = compute_digest ();
+      g_print ("%s\n", pattern);
+      g_free (pattern);
+      return;
+    }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_cpu_init ();
+  if (g_str_equal (kernels, "avx2"))
+    supported = __builtin_cpu_supports ("avx2");
+  else
+    supported = __builtin_cpu_supports ("sse2");
+#else
+  /* there are only scalar kernels on other platforms */
+  supported = FALSE;
+#endif
+
+  if (!supported)
+    {
+      g_test_skip ("the kernels are not supported on this machine");
+      return;
+    }
+
+  /* the parent uses the scalar kernels, see main() */
+  if (reference == NULL)
+    reference = compute_digest ();
+
+  /* the kernels are picked once per process */
+  g_setenv ("EXO_GDK_PIXBUF_KERNELS", kernels, TRUE);
+  g_test_trap_subprocess (NULL, 0, 0);
+  g_test_trap_assert_passed ();
+
+  pattern = g_strdup_printf ("%s\n", reference);
+  g_test_trap_assert_stdout (pattern);
+  g_free (pattern);
+}
+
+
+
+gint
+main (gint    argc,
+      gchar **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  /* compute the reference with the scalar kernels, the subprocesses
+   * inherit the kernels to compare with instead
+   */
+  if (!g_test_subprocess ())
+    g_setenv ("EXO_GDK_PIXBUF_KERNELS", "scalar", TRUE);
+
+  g_test_add_data_func ("/gdk-pixbuf/kernels-sse2", "sse2", test_gdk_pixbuf_kernels);
+  g_test_add_data_func ("/gdk-pixbuf/kernels-avx2", "avx2", test_gdk_pixbuf_kernels);
+
+  return g_test_run ();
+}
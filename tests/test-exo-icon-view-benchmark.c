@@ -0,0 +1,328 @@
+/*-
+ * Copyright (c) 2020 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#include <exo/exo.h>
+
+
+
+/* Headless benchmark for ExoIconView. The view is placed in an offscreen
+ * window and every operation is timed with the number of heap allocations
+ * it performed, so quadratic behavior shows up when comparing the results
+ * for the different model sizes. Pass the model sizes on the command line
+ * to override the defaults.
+ */
+
+#define BENCHMARK_WIDTH  (800)
+#define BENCHMARK_HEIGHT (600)
+
+
+
+enum
+{
+  COLUMN_PIXBUF,
+  COLUMN_NAME,
+  N_COLUMNS
+};
+
+
+
+#ifdef __GLIBC__
+/* count the allocations by wrapping the glibc allocator */
+extern void *__libc_malloc  (size_t size);
+extern void *__libc_calloc  (size_t n_members, size_t size);
+extern void *__libc_realloc (void *mem, size_t size);
+
+static gint n_allocations = 0;
+
+void*
+malloc (size_t size)
+{
+  g_atomic_int_inc (&n_allocations);
+  return __libc_malloc (size);
+}
+
+
+
+void*
+calloc (size_t n_members,
+        size_t size)
+{
+  g_atomic_int_inc (&n_allocations);
+  return __libc_calloc (n_members, size);
+}
+
+
+
+void*
+realloc (void *mem,
+         size_t size)
+{
+  g_atomic_int_inc (&n_allocations);
+  return __libc_realloc (mem, size);
+}
+#define benchmark_get_allocations() ((guint) g_atomic_int_get (&n_allocations))
+#else
+#define benchmark_get_allocations() (0u)
+#endif
+
+
+
+typedef struct
+{
+  const gchar *name;
+  gint64       start_time;
+  guint        start_allocations;
+} Benchmark;
+
+
+
+static void
+benchmark_begin (Benchmark   *benchmark,
+                 const gchar *name)
+{
+  benchmark->name = name;
+  benchmark->start_allocations = benchmark_get_allocations ();
+  benchmark->start_time = g_get_monotonic_time ();
+}
+
+
+
+static void
+benchmark_end (Benchmark *benchmark,
+               guint      n_items)
+{
+  gint64 elapsed = g_get_monotonic_time () - benchmark->start_time;
+  guint  n_allocs = benchmark_get_allocations () - benchmark->start_allocations;
+
+  g_print ("%-20s %8u items %12.3f ms %12u allocs\n",
+           benchmark->name, n_items, elapsed / 1000.0, n_allocs);
+}
+
+
+
+static void
+benchmark_flush (void)
+{
+  /* run the pending layout and redraw idles */
+  while (gtk_events_pending ())
+    gtk_main_iteration ();
+}
+
+
+
+static void
+benchmark_draw (GtkWidget       *icon_view,
+                cairo_surface_t *surface)
+{
+  cairo_t *cr;
+
+  cr = cairo_create (surface);
+  gtk_widget_draw (icon_view, cr);
+  cairo_destroy (cr);
+}
+
+
+
+static void
+benchmark_count_selected (ExoIconView *icon_view,
+                          GtkTreePath *path,
+                          gpointer     user_data)
+{
+  *((guint *) user_data) += 1;
+}
+
+
+
+static GtkListStore*
+benchmark_create_store (guint      n_items,
+                        GdkPixbuf *pixbuf)
+{
+  GtkListStore *store;
+  GtkTreeIter   iter;
+  gchar        *name;
+  guint         n;
+
+  store = gtk_list_store_new (N_COLUMNS, GDK_TYPE_PIXBUF, G_TYPE_STRING);
+  for (n = 0; n < n_items; ++n)
+    {
+      /* vary the name length a bit to get different item sizes */
+      name = g_strdup_printf ("Item %u%s", n, (n % 7 == 0) ? " with a longer name" : "");
+      gtk_list_store_insert_with_values (store, &iter, -1, COLUMN_PIXBUF, pixbuf, COLUMN_NAME, name, -1);
+      g_free (name);
+    }
+
+  return store;
+}
+
+
+
+static void
+benchmark_run (guint n_items)
+{
+  cairo_surface_t *surface;
+  GtkAdjustment   *vadjustment;
+  GtkCellRenderer *renderer;
+  GtkListStore    *store;
+  GtkTreePath     *path;
+  Benchmark        benchmark;
+  GdkPixbuf       *pixbuf;
+  GtkWidget       *window;
+  GtkWidget       *swin;
+  GtkWidget       *icon_view;
+  guint            n_selected;
+  gint             x, y;
+
+  pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, 48, 48);
+  gdk_pixbuf_fill (pixbuf, 0x3465a4ff);
+
+  benchmark_begin (&benchmark, "fill-model");
+  store = benchmark_create_store (n_items, pixbuf);
+  benchmark_end (&benchmark, n_items);
+
+  window = gtk_offscreen_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+
+  swin = gtk_scrolled_window_new (NULL, NULL);
+  gtk_container_add (GTK_CONTAINER (window), swin);
+
+  icon_view = exo_icon_view_new ();
+  exo_icon_view_set_selection_mode (EXO_ICON_VIEW (icon_view), GTK_SELECTION_MULTIPLE);
+  exo_icon_view_set_pixbuf_column (EXO_ICON_VIEW (icon_view), COLUMN_PIXBUF);
+  exo_icon_view_set_search_column (EXO_ICON_VIEW (icon_view), COLUMN_NAME);
+
+  renderer = gtk_cell_renderer_text_new ();
+  gtk_cell_layout_pack_start (GTK_CELL_LAYOUT (icon_view), renderer, FALSE);
+  gtk_cell_layout_add_attribute (GTK_CELL_LAYOUT (icon_view), renderer, "text", COLUMN_NAME);
+  gtk_container_add (GTK_CONTAINER (swin), icon_view);
+
+  gtk_widget_show_all (window);
+  benchmark_flush ();
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (icon_view));
+
+  benchmark_begin (&benchmark, "set-model");
+  exo_icon_view_set_model (EXO_ICON_VIEW (icon_view), GTK_TREE_MODEL (store));
+  benchmark_end (&benchmark, n_items);
+
+  benchmark_begin (&benchmark, "layout");
+  benchmark_flush ();
+  benchmark_end (&benchmark, n_items);
+
+  benchmark_begin (&benchmark, "relayout");
+  gtk_widget_set_size_request (swin, BENCHMARK_WIDTH / 2, -1);
+  benchmark_flush ();
+  gtk_widget_set_size_request (swin, -1, -1);
+  benchmark_flush ();
+  benchmark_end (&benchmark, n_items);
+
+  benchmark_begin (&benchmark, "draw-top");
+  benchmark_draw (icon_view, surface);
+  benchmark_end (&benchmark, n_items);
+
+  benchmark_begin (&benchmark, "draw-bottom");
+  gtk_adjustment_set_value (vadjustment, gtk_adjustment_get_upper (vadjustment));
+  benchmark_flush ();
+  benchmark_draw (icon_view, surface);
+  benchmark_end (&benchmark, n_items);
+  gtk_adjustment_set_value (vadjustment, 0.0);
+  benchmark_flush ();
+
+  /* the rubberband follows the real pointer position, which an offscreen
+   * window does not have, so sweep the same area with the hit-testing and
+   * selection calls the rubberband selection uses instead */
+  benchmark_begin (&benchmark, "rubberband-sweep");
+  for (y = 0; y < BENCHMARK_HEIGHT; y += 8)
+    for (x = 0; x < BENCHMARK_WIDTH; x += 8)
+      {
+        path = exo_icon_view_get_path_at_pos (EXO_ICON_VIEW (icon_view), x, y);
+        if (path != NULL)
+          {
+            exo_icon_view_select_path (EXO_ICON_VIEW (icon_view), path);
+            gtk_tree_path_free (path);
+          }
+      }
+  benchmark_flush ();
+  benchmark_end (&benchmark, n_items);
+
+  benchmark_begin (&benchmark, "select-all");
+  exo_icon_view_select_all (EXO_ICON_VIEW (icon_view));
+  benchmark_flush ();
+  benchmark_end (&benchmark, n_items);
+
+  benchmark_begin (&benchmark, "selected-foreach");
+  n_selected = 0;
+  exo_icon_view_selected_foreach (EXO_ICON_VIEW (icon_view), benchmark_count_selected, &n_selected);
+  benchmark_end (&benchmark, n_items);
+  g_assert_cmpuint (n_selected, ==, n_items);
+
+  benchmark_begin (&benchmark, "unselect-all");
+  exo_icon_view_unselect_all (EXO_ICON_VIEW (icon_view));
+  benchmark_flush ();
+  benchmark_end (&benchmark, n_items);
+
+  benchmark_begin (&benchmark, "unset-model");
+  exo_icon_view_set_model (EXO_ICON_VIEW (icon_view), NULL);
+  benchmark_flush ();
+  benchmark_end (&benchmark, n_items);
+
+  g_print ("\n");
+
+  cairo_surface_destroy (surface);
+  gtk_widget_destroy (window);
+  g_object_unref (G_OBJECT (store));
+  g_object_unref (G_OBJECT (pixbuf));
+}
+
+
+
+int
+main (int argc, char **argv)
+{
+  static const guint default_sizes[] = { 1000, 10000, 100000 };
+  guint              n;
+
+  if (!gtk_init_check (&argc, &argv))
+    {
+      /* tell automake the benchmark was skipped */
+      g_printerr ("%s: no display available, skipping\n", argv[0]);
+      return 77;
+    }
+
+  if (argc > 1)
+    {
+      for (n = 1; n < (guint) argc; ++n)
+        benchmark_run (strtoul (argv[n], NULL, 10));
+    }
+  else
+    {
+      for (n = 0; n < G_N_ELEMENTS (default_sizes); ++n)
+        benchmark_run (default_sizes[n]);
+    }
+
+  return EXIT_SUCCESS;
+}